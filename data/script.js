@@ -9,6 +9,8 @@ function initWebSocket() {
   websocket.onopen = () => {
     console.log("✅ WebSocket opened");
     sendJson({ page: "get_config" });
+    sendJson({ page: "get_history", value: { count: 40 } });
+    sendJson({ page: "get_sampling" });
   };
 
   websocket.onclose = () => {
@@ -42,12 +44,27 @@ function onMessage(event) {
   if (!data.page) return;
 
   switch (data.page) {
-    case "sensor":
-      updateSensorCard(data);
+    case "telemetry":
+      // Cùng khung dữ liệu với telemetry MQTT gửi CoreIoT
+      updateSensorCard({ temp: data.temperature, humi: data.humidity });
+      if (data.tiny_score !== undefined) {
+        updateTinyMlCard({ score: data.tiny_score, pred: data.tiny_pred, gt: data.tiny_gt, acc: data.tiny_acc });
+      }
+      break;
+
+    case "history":
+      fillHistoryData(data);
       break;
 
-    case "tinyml":
-      updateTinyMlCard(data);
+    case "timing":
+      console.table(data.value);
+      break;
+
+    case "tasks":
+      if (data.value.cores) console.table(data.value.cores);
+      console.table(data.value.tasks);
+      if (data.value.stacks) console.table(data.value.stacks);
+      if (data.value.jobs) console.table(data.value.jobs);
       break;
 
     case "config":
@@ -67,6 +84,15 @@ function onMessage(event) {
       setStatusMsg("threshold-msg", "✅ Đã lưu ngưỡng.", "success");
       break;
 
+    case "sampling_state":
+      fillSamplingData(data.value);
+      break;
+
+    case "sampling_saved":
+      setStatusMsg("sampling-msg", "✅ Đã lưu chế độ lấy mẫu.", "success");
+      sendJson({ page: "get_sampling" });
+      break;
+
     case "led_pattern_saved":
       setStatusMsg("led-msg", "✅ Đã lưu pattern LED.", "success");
       break;
@@ -86,6 +112,30 @@ function onMessage(event) {
   }
 }
 
+// Điền form lấy mẫu thích ứng + thống kê tần số hiệu dụng
+function fillSamplingData(s) {
+  if (!s) return;
+  document.getElementById("sampling-enabled").value = s.enabled ? "1" : "0";
+  document.getElementById("sampling-growth").value = s.growth;
+  document.getElementById("sampling-min").value = s.minPeriod;
+  document.getElementById("sampling-max").value = s.maxPeriod;
+  document.getElementById("sampling-temp-margin").value = s.tempMargin;
+  document.getElementById("sampling-humi-margin").value = s.humiMargin;
+  document.getElementById("sampling-temp-slope").value = s.tempSlope;
+  document.getElementById("sampling-humi-slope").value = s.humiSlope;
+
+  const el = document.getElementById("sampling-stats");
+  if (el) {
+    el.textContent =
+      `Chu kỳ hiện tại ${s.period} ms (${s.reason}), ` +
+      `${s.perMinute.toFixed(1)} mẫu/phút, tổng ${s.samples} mẫu`;
+    if (s.levels) {
+      const fmt = (l) => `${l.transitions} lần đổi (chặn ${l.heldHyst} hyst / ${l.heldDwell} dwell)`;
+      el.textContent += ` — Temp: ${fmt(s.levels.temp)}, Humi: ${fmt(s.levels.humi)}`;
+    }
+  }
+}
+
 // Hàm điền dữ liệu cấu hình ban đầu
 function fillConfigData(cfg) {
   console.log("📥 Filling config:", cfg);
@@ -96,6 +146,15 @@ function fillConfigData(cfg) {
     document.getElementById("temp-hot").value = cfg.thresholds.tempHot ?? 30;
     document.getElementById("humi-dry").value = cfg.thresholds.humiDry ?? 40;
     document.getElementById("humi-humid").value = cfg.thresholds.humiHumid ?? 70;
+    document.getElementById("temp-hyst").value = cfg.thresholds.tempHyst ?? 0.5;
+    document.getElementById("humi-hyst").value = cfg.thresholds.humiHyst ?? 2;
+    document.getElementById("level-dwell").value = cfg.thresholds.levelDwell ?? 4000;
+    document.getElementById("filter-mode").value = cfg.thresholds.filterMode ?? "median";
+    document.getElementById("filter-oversample").value = cfg.thresholds.oversample ?? 3;
+    document.getElementById("filter-spacing").value = cfg.thresholds.sampleSpacing ?? 1000;
+    document.getElementById("filter-alpha").value = cfg.thresholds.ewmaAlpha ?? 0.3;
+    document.getElementById("filter-q").value = cfg.thresholds.kalmanQ ?? 0.01;
+    document.getElementById("filter-r").value = cfg.thresholds.kalmanR ?? 0.25;
     currentThresholds = cfg.thresholds;
   }
 
@@ -151,10 +210,74 @@ function initNavigation() {
         if (p.id === target) p.classList.add("active");
         else p.classList.remove("active");
       });
+      // Chỉ hỏi /metrics khi trang Hệ thống đang mở
+      if (target === "page-system") startMetricsPolling();
+      else stopMetricsPolling();
     });
   });
 }
 
+// ================ TRANG HỆ THỐNG (/metrics) ================
+const METRICS_POLL_MS = 5000;
+let metricsTimer = null;
+
+function formatBytes(n) {
+  return n >= 1024 ? (n / 1024).toFixed(1) + " KB" : n + " B";
+}
+
+function metricRows(rows) {
+  return rows.map((r) => `<tr><td>${r[0]}</td><td>${r[1]}</td></tr>`).join("");
+}
+
+function renderMetrics(m) {
+  const h = m.heap || {};
+  document.getElementById("metric-heap-free").innerText = formatBytes(h.heapFree || 0);
+  document.getElementById("metric-heap-block").innerText = formatBytes(h.heapMaxBlock || 0);
+  document.getElementById("metric-heap-min").innerText = formatBytes(h.heapMinFree || 0);
+  document.getElementById("metric-heap-frag").innerText = (h.heapFrag || 0) + " %";
+  document.getElementById("metrics-uptime").innerText =
+    "Uptime: " + Math.floor((m.uptimeMs || 0) / 1000) + " s";
+
+  document.getElementById("metric-cores").innerHTML = metricRows(
+    (m.cores || []).map((c) => ["Core " + c.core, c.load.toFixed(1) + " %"])
+  );
+  document.getElementById("metric-counters").innerHTML = metricRows(
+    Object.keys(m.counters || {}).map((k) => [k, m.counters[k]])
+  );
+  // Độ trễ từ lúc đọc DHT20 tới từng sink: p50 / p99 / max
+  const ms = (us) => (us / 1000).toFixed(1);
+  document.getElementById("metric-latency").innerHTML = metricRows(
+    Object.keys(m.latency || {}).map((k) => {
+      const l = m.latency[k];
+      return ["Trễ " + k + " (ms)", `${ms(l.p50)} / ${ms(l.p99)} / ${ms(l.max)}`];
+    })
+  );
+
+  const tasks = (m.tasks || []).slice().sort((a, b) => b.cpu - a.cpu);
+  document.getElementById("metric-tasks").innerHTML = tasks
+    .map((t) => `<tr><td>${t.name}</td><td>${t.core < 0 ? "-" : t.core}</td><td>${t.prio}</td>` +
+                `<td>${t.cpu.toFixed(1)}</td><td>${t.stack}</td></tr>`)
+    .join("");
+}
+
+function pollMetrics() {
+  fetch("/metrics")
+    .then((r) => r.json())
+    .then(renderMetrics)
+    .catch((e) => console.warn("metrics:", e));
+}
+
+function startMetricsPolling() {
+  if (metricsTimer) return;
+  pollMetrics();
+  metricsTimer = setInterval(pollMetrics, METRICS_POLL_MS);
+}
+
+function stopMetricsPolling() {
+  clearInterval(metricsTimer);
+  metricsTimer = null;
+}
+
 // ================ QUẢN LÝ THIẾT BỊ (RELAY/LED) ================
 
 // 1. Định nghĩa danh sách thiết bị
@@ -267,11 +390,45 @@ function initForms() {
         humiDry: parseFloat(document.getElementById("humi-dry").value),
         humiHumid: parseFloat(document.getElementById("humi-humid").value),
       };
-      sendJson({ page: "threshold", value: currentThresholds });
+      const hysteresis = {
+        tempHyst: parseFloat(document.getElementById("temp-hyst").value),
+        humiHyst: parseFloat(document.getElementById("humi-hyst").value),
+        levelDwell: parseInt(document.getElementById("level-dwell").value),
+      };
+      const filter = {
+        filterMode: document.getElementById("filter-mode").value,
+        oversample: parseInt(document.getElementById("filter-oversample").value),
+        sampleSpacing: parseInt(document.getElementById("filter-spacing").value),
+        ewmaAlpha: parseFloat(document.getElementById("filter-alpha").value),
+        kalmanQ: parseFloat(document.getElementById("filter-q").value),
+        kalmanR: parseFloat(document.getElementById("filter-r").value),
+      };
+      sendJson({ page: "threshold", value: { ...currentThresholds, ...hysteresis, ...filter } });
       setStatusMsg("threshold-msg", "⏳ Đang gửi...", "info");
     });
   }
 
+  const samplingForm = document.getElementById("sampling-form");
+  if (samplingForm) {
+    samplingForm.addEventListener("submit", (e) => {
+      e.preventDefault();
+      sendJson({
+        page: "sampling",
+        value: {
+          enabled: document.getElementById("sampling-enabled").value === "1",
+          growth: parseFloat(document.getElementById("sampling-growth").value),
+          minPeriod: parseInt(document.getElementById("sampling-min").value),
+          maxPeriod: parseInt(document.getElementById("sampling-max").value),
+          tempMargin: parseFloat(document.getElementById("sampling-temp-margin").value),
+          humiMargin: parseFloat(document.getElementById("sampling-humi-margin").value),
+          tempSlope: parseFloat(document.getElementById("sampling-temp-slope").value),
+          humiSlope: parseFloat(document.getElementById("sampling-humi-slope").value),
+        },
+      });
+      setStatusMsg("sampling-msg", "⏳ Đang gửi...", "info");
+    });
+  }
+
   const ledForm = document.getElementById("temp-led-form");
   if (ledForm) {
     ledForm.addEventListener("submit", (e) => {
@@ -419,6 +576,26 @@ function updateMainChartData(temp, humi) {
   mainChart.update();
 }
 
+// Nạp lịch sử từ ring buffer trên board (khi vừa mở trang / kết nối lại)
+function fillHistoryData(data) {
+  if (!Array.isArray(data.age) || !Array.isArray(data.temp) || !Array.isArray(data.humi)) return;
+
+  const now = Date.now();
+  const labels = data.age.map(a => new Date(now - a).toLocaleTimeString('vi-VN', { hour12: false, hour:'2-digit', minute:'2-digit', second:'2-digit' }));
+
+  if (mainChartUseFallback) {
+    mainChartHistory = { labels: labels, temp: data.temp.slice(), humi: data.humi.slice() };
+    drawMainChartFallback();
+    return;
+  }
+
+  if (!mainChart) return;
+  mainChart.data.labels = labels;
+  mainChart.data.datasets[0].data = data.temp.slice();
+  mainChart.data.datasets[1].data = data.humi.slice();
+  mainChart.update();
+}
+
 function drawMainChartFallback() {
   if (!mainChartUseFallback || !mainChartCanvas || !mainChartCtx) return;
   if (mainChartHistory.labels.length === 0) return;
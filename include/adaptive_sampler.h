@@ -0,0 +1,81 @@
+#ifndef __ADAPTIVE_SAMPLER_H__
+#define __ADAPTIVE_SAMPLER_H__
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include "global.h"
+#include "runtime_config.h"
+
+// Giới hạn cứng cho chu kỳ lấy mẫu (ms)
+#define SAMPLER_PERIOD_FLOOR_MS    1000
+#define SAMPLER_PERIOD_CEIL_MS     60000
+
+// Lý do chọn chu kỳ ở lần gần nhất
+enum SamplerReason : uint8_t {
+  SAMPLER_REASON_STABLE = 0,   // xa ngưỡng, thay đổi chậm → giãn dần
+  SAMPLER_REASON_NEAR,         // gần ngưỡng → chu kỳ nhanh
+  SAMPLER_REASON_SLOPE,        // đạo hàm lớn → chu kỳ nhanh
+  SAMPLER_REASON_ANOMALY,      // TinyML báo bất thường → chu kỳ nhanh
+  SAMPLER_REASON_ERROR,        // đọc lỗi → thử lại nhanh
+  SAMPLER_REASON_COUNT
+};
+
+struct SamplerConfig {
+  bool     enabled;            // false = luôn dùng min_period_ms
+  uint32_t min_period_ms;
+  uint32_t max_period_ms;
+  float    temp_margin;        // °C: khoảng cách tới ngưỡng coi là "gần"
+  float    humi_margin;        // %RH
+  float    temp_slope;         // °C/phút coi là thay đổi nhanh
+  float    humi_slope;         // %RH/phút
+  float    growth;             // hệ số giãn chu kỳ mỗi lần ổn định (> 1)
+};
+
+struct SamplerStats {
+  uint32_t period_ms;          // chu kỳ hiện tại
+  uint8_t  reason;             // SamplerReason của lần gần nhất
+  uint32_t samples;
+  uint32_t since_ms;           // mốc bắt đầu thống kê
+  uint32_t reasons[SAMPLER_REASON_COUNT];
+};
+
+// Chọn chu kỳ lấy mẫu kế tiếp theo động học tín hiệu.
+// Chỉ temp_humi_monitor gọi next(); cấu hình / thống kê đọc được từ task khác.
+class AdaptiveSampler
+{
+public:
+  AdaptiveSampler();
+
+  // Trả về chu kỳ (ms) tới lần đo kế tiếp sau mẫu vừa đọc.
+  // anomaly: kết quả TinyML gần nhất (nhận qua event bus)
+  // rc: ảnh cấu hình caller đã đọc cho chu kỳ này (ngưỡng)
+  uint32_t next(uint32_t nowMs, bool valid, float temperature, float humidity,
+                bool anomaly, const RuntimeConfig &rc);
+
+  void setConfig(const SamplerConfig &cfg);
+  void getConfig(SamplerConfig &out);
+  void getStats(SamplerStats &out);
+  void resetStats();
+
+  // Ghi cấu hình + thống kê (kèm tần số hiệu dụng) vào object JSON
+  void toJson(JsonObject out);
+
+private:
+  static float distanceToBand(float value, float low, float high);
+
+  SamplerConfig _cfg;
+  SamplerStats  _stats;
+  portMUX_TYPE  _mux;
+
+  bool     _hasLast;
+  uint32_t _lastMs;
+  float    _lastTemp;
+  float    _lastHumi;
+  float    _period;            // float để giãn theo hệ số không bị làm tròn
+};
+
+const char *samplerReasonName(uint8_t reason);
+
+extern AdaptiveSampler adaptiveSampler;
+
+#endif
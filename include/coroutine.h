@@ -0,0 +1,104 @@
+#ifndef __COROUTINE_H__
+#define __COROUTINE_H__
+
+#include <Arduino.h>
+#include "executor.h"
+
+// Coroutine không stack (kiểu protothread) chạy như một job của executor.
+// Thân coroutine nằm trong step function của job:
+//
+//   static CoState co;
+//   static uint32_t myStep(const EventMsg *msg, void *ctx)
+//   {
+//     CO_BEGIN(co);
+//     ...
+//     CO_DELAY(co, 500);
+//     CO_AWAIT_FOR(co, WiFi.status() == WL_CONNECTED, 15000);
+//     if (!co.ok) ...
+//     CO_END(co);
+//   }
+//
+// Quy tắc: mọi biến cần giữ qua một điểm chờ phải là static / nằm trong struct
+// của job (biến cục bộ mất giá trị khi step trả về). Không đặt điểm chờ trong
+// switch của chính thân coroutine.
+//
+// Thân coroutine chạy trên task executor dùng chung với LED / NeoPixel / nút
+// BOOT nên không được gọi gì chặn. Vì vậy luồng MQTT (PubSubClient connect /
+// publish là lệnh socket chặn) và luồng monitor (subscriber LCD, sink telemetry
+// chạy đồng bộ trong task phát mẫu và chờ I2C) vẫn giữ task riêng.
+
+struct CoState {
+  uint16_t line;       // điểm tiếp tục, 0 = đầu thân
+  bool     ok;         // kết quả của CO_AWAIT_FOR / CO_WAIT_FOR
+  uint32_t startMs;    // thời điểm bắt đầu chờ, cho timeout / CO_DELAY
+};
+
+#define CO_BEGIN(co)   switch ((co).line) { case 0:
+
+// Hết thân: về lại đầu ở lần chạy kế tiếp, chỉ chạy lại khi có sự kiện
+#define CO_END(co)     } (co).line = 0; return EXEC_WAIT_EVENT
+
+// Nhường executor, chạy tiếp sau ms mili-giây. Job có topicMask có thể bị
+// gọi lại sớm vì sự kiện: khi đó chưa tới hạn thì ngủ tiếp phần còn lại.
+#define CO_DELAY(co, ms)                                                  \
+  do {                                                                    \
+    (co).line    = __LINE__;                                              \
+    (co).startMs = millis();                                              \
+    return (uint32_t)(ms);                                                \
+    case __LINE__:                                                        \
+    {                                                                     \
+      uint32_t coSlept = millis() - (co).startMs;                         \
+      if (coSlept < (uint32_t)(ms))                                       \
+        return (uint32_t)(ms) - coSlept;                                  \
+    }                                                                     \
+  } while (0)
+
+// Nhường executor, chạy tiếp ở vòng kế tiếp
+#define CO_YIELD(co)   CO_DELAY(co, 0)
+
+// Chờ tới khi cond đúng. cond được đánh giá lại mỗi khi executor thức
+// (sự kiện bus) và tối thiểu mỗi EXECUTOR_AWAIT_POLL_MS.
+#define CO_AWAIT(co, cond)                  \
+  do {                                      \
+    (co).line = __LINE__;                   \
+    case __LINE__:                          \
+    if (!(cond)) return EXEC_AWAIT;         \
+  } while (0)
+
+// Như CO_AWAIT nhưng bỏ cuộc sau timeoutMs; co.ok = cond lúc kết thúc.
+// cond chỉ được đánh giá 1 lần mỗi lượt (an toàn với xSemaphoreTake, xQueueReceive).
+#define CO_AWAIT_FOR(co, cond, timeoutMs)                              \
+  do {                                                                 \
+    (co).line    = __LINE__;                                           \
+    (co).startMs = millis();                                           \
+    case __LINE__:                                                     \
+    (co).ok = (cond);                                                  \
+    if (!(co).ok && millis() - (co).startMs < (uint32_t)(timeoutMs))   \
+      return EXEC_AWAIT;                                               \
+  } while (0)
+
+// Như CO_AWAIT / CO_AWAIT_FOR nhưng không poll: cond chỉ được đánh giá lại khi
+// job được báo (executorSignal, sự kiện bus của job) hoặc khi hết timeoutMs.
+// Chỉ dùng khi bên làm đổi cond luôn báo job.
+#define CO_WAIT(co, cond)                   \
+  do {                                      \
+    (co).line = __LINE__;                   \
+    case __LINE__:                          \
+    if (!(cond)) return EXEC_WAIT_EVENT;    \
+  } while (0)
+
+#define CO_WAIT_FOR(co, cond, timeoutMs)                                  \
+  do {                                                                    \
+    (co).line    = __LINE__;                                              \
+    (co).startMs = millis();                                              \
+    case __LINE__:                                                        \
+    (co).ok = (cond);                                                     \
+    if (!(co).ok)                                                         \
+    {                                                                     \
+      uint32_t coWaited = millis() - (co).startMs;                        \
+      if (coWaited < (uint32_t)(timeoutMs))                               \
+        return (uint32_t)(timeoutMs) - coWaited;                          \
+    }                                                                     \
+  } while (0)
+
+#endif
@@ -0,0 +1,138 @@
+#ifndef __EVENT_BUS_H__
+#define __EVENT_BUS_H__
+
+#include <Arduino.h>
+#include <atomic>
+#include "global.h"
+
+// ====== Kích thước tĩnh của bus ======
+#define EVENT_BUS_POOL_SIZE        16   // số message dùng chung cho mọi topic
+#define EVENT_BUS_MAX_SUBSCRIBERS  12
+#define EVENT_BUS_QUEUE_SLOTS      32   // tổng queue_depth của mọi subscriber kiểu QUEUE
+#define EVENT_PAYLOAD_MAX          32
+// Bit notification dành cho bus (bit 31 đã dành cho I2C bus)
+#define EVENT_BUS_NOTIFY_BIT       (1UL << 30)
+
+enum EventTopic : uint8_t {
+  TOPIC_SENSOR_SAMPLE = 0,   // SensorSnapshot, mỗi mẫu đã lọc
+  TOPIC_LEVEL_CHANGE,        // LevelChangeEvent, khi mức nhiệt/ẩm đổi
+  TOPIC_CONFIG_CHANGE,       // ConfigChangeEvent, khi WebUI / RPC đổi cấu hình
+  TOPIC_ML_RESULT,           // MlResultEvent, mỗi lần TinyML suy luận xong
+  TOPIC_COUNT
+};
+
+#define TOPIC_MASK(topic)  (1UL << (topic))
+
+// ====== Payload của từng topic ======
+#define LEVEL_CHANGED_TEMP  0x01
+#define LEVEL_CHANGED_HUMI  0x02
+
+struct LevelChangeEvent {
+  uint8_t temp_level;
+  uint8_t humi_level;
+  uint8_t display_state;
+  uint8_t changed;           // LEVEL_CHANGED_*
+};
+
+enum ConfigSection : uint8_t {
+  CONFIG_THRESHOLDS = 0,
+  CONFIG_LED_PATTERN,
+  CONFIG_NEO_COLOR,
+  CONFIG_DEVICE_ENABLE,      // bật/tắt LED1/LED2
+  CONFIG_SAMPLING
+};
+
+struct ConfigChangeEvent {
+  uint8_t section;           // ConfigSection
+};
+
+struct MlResultEvent {
+  float    score;
+  float    accuracy;
+  bool     pred_anomaly;
+  bool     gt_anomaly;
+  uint32_t sample_seq;     // SensorSnapshot::seq của mẫu đã suy luận
+};
+
+// Message dùng chung (zero-copy): mọi subscriber nhận cùng một con trỏ,
+// message về pool khi người giữ cuối cùng gọi eventRelease().
+struct EventMsg {
+  std::atomic<uint32_t> refs;
+  uint8_t  topic;
+  uint8_t  len;
+  uint32_t seq;              // tăng theo từng topic
+  uint32_t timestamp_ms;
+  union {
+    uint8_t  bytes[EVENT_PAYLOAD_MAX];
+    uint32_t align_;
+  } payload;
+
+  template <typename T>
+  const T &as() const { return *reinterpret_cast<const T *>(payload.bytes); }
+};
+
+// ====== Cách giao message cho subscriber ======
+enum EventDelivery : uint8_t {
+  EVENT_DELIVER_QUEUE = 0,   // hàng đợi riêng, giữ đủ mọi message tới queue_depth
+                             // (kèm notify bit bus cho owner, như LATEST)
+  EVENT_DELIVER_LATEST,      // mỗi topic 1 ô, message mới thay message chưa đọc
+  EVENT_DELIVER_CALLBACK     // gọi hàm ngay trong ngữ cảnh của publisher
+};
+
+// Khi hàng đợi đầy: bỏ message cũ nhất hay message mới
+enum EventOverflow : uint8_t {
+  EVENT_DROP_OLDEST = 0,
+  EVENT_DROP_NEWEST
+};
+
+typedef void (*EventCallback)(const EventMsg *msg, void *ctx);
+
+struct EventSubOptions {
+  EventDelivery delivery;
+  uint8_t       queue_depth;  // EVENT_DELIVER_QUEUE
+  EventOverflow overflow;     // EVENT_DELIVER_QUEUE
+  EventCallback callback;     // EVENT_DELIVER_CALLBACK (không được block lâu)
+  void         *ctx;
+};
+
+struct EventSubscription;
+
+struct EventBusStats {
+  uint32_t published;
+  uint32_t delivered;
+  uint32_t coalesced;        // message chưa đọc bị thay ở chế độ LATEST
+  uint32_t overflowed;       // message bị bỏ vì hàng đợi subscriber đầy
+  uint32_t pool_empty;       // publish thất bại vì hết message trong pool
+};
+
+// Khởi tạo pool, gọi 1 lần trong setup() trước khi tạo task
+void eventBusBegin();
+
+// Đăng ký nhận các topic trong topicMask. Task gọi hàm này là task được
+// đánh thức (EVENT_DELIVER_LATEST) và là task duy nhất được gọi eventReceive().
+EventSubscription *eventSubscribe(uint32_t topicMask, const EventSubOptions &opts);
+
+// Tiện dụng cho trường hợp hay gặp
+EventSubscription *eventSubscribeLatest(uint32_t topicMask);
+EventSubscription *eventSubscribeQueue(uint32_t topicMask, uint8_t depth,
+                                       EventOverflow overflow = EVENT_DROP_OLDEST);
+EventSubscription *eventSubscribeCallback(uint32_t topicMask, EventCallback fn, void *ctx);
+
+// Phát message: payload được chép 1 lần vào pool rồi chia sẻ cho mọi subscriber
+bool eventPublish(uint8_t topic, const void *payload, size_t len);
+
+template <typename T>
+inline bool eventPublish(uint8_t topic, const T &payload)
+{
+  static_assert(sizeof(T) <= EVENT_PAYLOAD_MAX, "event payload too large");
+  return eventPublish(topic, &payload, sizeof(T));
+}
+
+// Lấy message kế tiếp, chờ tối đa timeout. nullptr nếu hết giờ.
+// Message nhận được phải trả lại bằng eventRelease().
+EventMsg *eventReceive(EventSubscription *sub, TickType_t timeout);
+void eventRelease(EventMsg *msg);
+
+void eventBusGetStats(EventBusStats &out);
+
+#endif
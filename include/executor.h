@@ -0,0 +1,48 @@
+#ifndef __EXECUTOR_H__
+#define __EXECUTOR_H__
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include "global.h"
+#include "event_bus.h"
+#include "timer_wheel.h"
+
+#define EXECUTOR_MAX_JOBS     8
+#define EXECUTOR_QUEUE_DEPTH  8     // sự kiện chờ xử lý của mọi job cộng lại
+// Job đang EXEC_AWAIT được chạy lại mỗi khi executor được đánh thức (sự kiện
+// bus), và tối thiểu theo chu kỳ này cho điều kiện không ai báo
+#define EXECUTOR_AWAIT_POLL_MS  20
+// Bit của timer wheel / ISR: chỉ job được đánh dấu chạy, job EXEC_AWAIT không bị đánh thức
+#define EXECUTOR_TIMER_BIT    (1UL << 28)
+
+// Giá trị trả về đặc biệt của ExecStepFn (ngoài số ms tới lần chạy kế tiếp)
+#define EXEC_WAIT_EVENT   0xFFFFFFFFUL   // huỷ timer, chỉ chạy lại khi có sự kiện
+#define EXEC_KEEP_TIMER   0xFFFFFFFEUL   // giữ nguyên deadline đang đặt
+#define EXEC_AWAIT        0xFFFFFFFDUL   // đang chờ điều kiện: chạy lại khi executor thức
+
+// Một bước của job (state machine), không được block:
+//   msg == nullptr  → timer của job đến hạn (hoặc lần chạy đầu tiên)
+//   msg != nullptr  → sự kiện thuộc topicMask của job; msg chỉ hợp lệ trong lúc gọi
+// Trả về số ms tới lần chạy kế tiếp, EXEC_WAIT_EVENT, EXEC_KEEP_TIMER hoặc EXEC_AWAIT.
+typedef uint32_t (*ExecStepFn)(const EventMsg *msg, void *ctx);
+
+struct ExecJob;
+
+// Đăng ký job chạy trên task executor dùng chung. Gọi trong setup() sau
+// timerWheelBegin() và trước khi tạo task executor; job chạy lần đầu ngay khi
+// executor khởi động. Trả về nullptr nếu hết chỗ.
+ExecJob *executorAdd(const char *name, uint32_t topicMask, ExecStepFn step, void *ctx);
+
+// Task duy nhất chạy mọi job. Deadline của job nằm trên timer wheel nên task
+// ngủ vô hạn tới khi có timer, sự kiện hoặc notification.
+void executor_task(void *pvParameters);
+
+// Cho job chạy ở vòng kế tiếp (msg == nullptr), kể cả khi job đang EXEC_WAIT_EVENT
+void executorSignal(ExecJob *job);
+// Như trên, gọi từ ISR (GPIO, ...)
+void IRAM_ATTR executorSignalFromISR(ExecJob *job);
+
+// Số lần chạy và thời gian chạy dài nhất của từng job
+void executorStatsToJson(JsonArray out);
+
+#endif
@@ -0,0 +1,32 @@
+#ifndef __FIXED_POINT_H__
+#define __FIXED_POINT_H__
+
+#include <Arduino.h>
+
+// Giá trị cảm biến dạng số nguyên: 0.01 °C / 0.01 %RH.
+// Bật đường xử lý nguyên bằng build flag -D SENSOR_FIXED_POINT:
+// đọc DHT20, lọc, phân loại ngưỡng, map độ sáng và format JSON/LCD
+// đều chạy trên centi_t; chỉ đổi sang float ở consumer cần float (TinyML).
+typedef int32_t centi_t;
+
+#define CENTI_SCALE  100
+
+inline centi_t centiFromFloat(float v)
+{
+  return (centi_t)(v >= 0.0f ? v * CENTI_SCALE + 0.5f : v * CENTI_SCALE - 0.5f);
+}
+
+inline float centiToFloat(centi_t v)
+{
+  return v * (1.0f / CENTI_SCALE);
+}
+
+// Map tuyến tính [inMin, inMax] → [outMin, outMax], kẹp ở hai đầu
+uint8_t mapBrightnessCenti(centi_t x, centi_t inMin, centi_t inMax,
+                           uint8_t outMin, uint8_t outMax);
+
+// Format "-12.34" với decimals = 0..2 chữ số lẻ (làm tròn), không dùng printf float.
+// Trả về số ký tự đã ghi (không tính '\0').
+size_t formatCenti(char *buf, size_t len, centi_t value, uint8_t decimals);
+
+#endif
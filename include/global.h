@@ -6,10 +6,6 @@
 #include "freertos/task.h"
 #include "freertos/semphr.h"
 
-// ====== Giá trị cảm biến toàn cục ======
-extern float glob_temperature;
-extern float glob_humidity;
-
 // ====== Ngưỡng & mức nhiệt độ / độ ẩm (giá trị mặc định) ======
 #define TEMP_COLD_THRESHOLD   24.0f
 #define TEMP_HOT_THRESHOLD    32.0f
@@ -17,6 +13,11 @@ extern float glob_humidity;
 #define HUMI_DRY_THRESHOLD    30.0f
 #define HUMI_HUMID_THRESHOLD  80.0f
 
+// Hysteresis (°C / %RH) và thời gian dừng tối thiểu khi đổi mức
+#define LEVEL_TEMP_HYSTERESIS 0.5f
+#define LEVEL_HUMI_HYSTERESIS 2.0f
+#define LEVEL_DWELL_MS        4000
+
 enum TempLevel : uint8_t {
   TEMP_LEVEL_COLD = 0,
   TEMP_LEVEL_NORMAL,
@@ -48,30 +49,36 @@ struct NeoColorConfig {
   uint8_t b;
 };
 
-// Các mức hiện tại, được temp_humi_monitor cập nhật
-extern volatile uint8_t glob_temp_level;
-extern volatile uint8_t glob_humi_level;
-extern volatile uint8_t glob_display_state;
+// ====== Ảnh chụp cảm biến dùng chung ======
+// temp_humi_monitor là writer duy nhất; các task khác đọc qua seqlock
+// nên luôn nhận được cặp nhiệt/ẩm và mức của cùng một mẫu, không cần mutex.
+struct SensorSnapshot {
+  float    temperature;
+  float    humidity;
+  int16_t  temp_centi;     // cùng giá trị, đơn vị 0.01 °C / 0.01 %RH
+  int16_t  humi_centi;     // có dấu: mẫu lỗi mang -1.00 (-100) như bản float
+  uint8_t  temp_level;
+  uint8_t  humi_level;
+  uint32_t timestamp_ms;   // millis() lúc đọc xong mẫu
+  uint32_t acquired_us;    // esp_timer_get_time() (32 bit thấp) lúc DHT20 đọc xong, đo độ trễ
+  uint32_t seq;            // tăng mỗi mẫu, 0 = chưa có mẫu nào
+};
 
-// Ngưỡng runtime có thể chỉnh từ WebUI
-extern float tempColdThreshold;
-extern float tempHotThreshold;
-extern float humiDryThreshold;
-extern float humiHumidThreshold;
+// Publish một mẫu mới (chỉ gọi từ temp_humi_monitor)
+void publishSensorSnapshot(float temperature, float humidity,
+                           uint8_t tempLevel, uint8_t humiLevel, uint32_t acquiredUs);
+// Bản cho SENSOR_FIXED_POINT: nhận 0.01 đơn vị, float được suy ra cho consumer cần float
+void publishSensorSnapshotCenti(int32_t tempCenti, int32_t humiCenti,
+                                uint8_t tempLevel, uint8_t humiLevel, uint32_t acquiredUs);
 
-// Cấu hình LED runtime
-extern TempLedConfig tempLedConfig[3];
-extern NeoColorConfig neoColorConfig[3];
+// Đọc mẫu mới nhất vào out. Trả về true nếu out.seq khác lastSeq,
+// tức là có mẫu mới kể từ lần đọc trước của consumer.
+bool readSensorSnapshot(SensorSnapshot &out, uint32_t lastSeq = 0);
 
-// Cho phép bật/tắt LED từ Web UI
-extern volatile bool glob_temp_led_enabled;
-extern volatile bool glob_humi_led_enabled;
+// Trạng thái hiển thị hiện tại, được temp_humi_monitor cập nhật
+extern volatile uint8_t glob_display_state;
 
-// ====== TinyML runtime result (cho CoreIoT & WebServer) ======
-extern float tinyml_score;
-extern float tinyml_accuracy;
-extern bool  tinyml_pred_anomaly;
-extern bool  tinyml_gt_anomaly;
+// Ngưỡng, pattern LED, màu NeoPixel và bật/tắt LED: xem runtime_config.h
 
 // ====== WiFi / CoreIoT config ======
 extern String WIFI_SSID;
@@ -94,10 +101,4 @@ extern bool isWifiConnected;
 // Semaphore báo có internet 
 extern SemaphoreHandle_t xBinarySemaphoreInternet;
 
-// ====== Semaphore đồng bộ các task  ======
-// Được temp_humi_monitor "give" khi mức nhiệt thay đổi → Task LED dùng.
-extern SemaphoreHandle_t xTempLedSemaphore;
-// Được temp_humi_monitor "give" khi mức ẩm thay đổi → Task NeoPixel dùng.
-extern SemaphoreHandle_t xHumiNeoSemaphore;
-
 #endif
@@ -0,0 +1,48 @@
+#ifndef __HEAP_STATS_H__
+#define __HEAP_STATS_H__
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include "global.h"
+
+// Đếm cấp phát heap theo task và theo tag call site (số lần alloc / free,
+// byte cấp / trả, lần cấp lỗi). Chỉ có khi build với env yolo_uno_heapstat:
+// -DHEAP_STATS cùng -Wl,--wrap=malloc,free,... nên mọi cấp phát (String,
+// new, ArduinoJson, strdup) đều đi qua bộ đếm. Không bật thì HEAP_TAG rỗng.
+//
+// Free được tính cho task / tag đang free, không phải nơi đã cấp.
+
+// Task / tag vượt bảng được gom vào dòng đầu ("other" / "untagged")
+#define HEAP_STATS_MAX_TASKS  24
+#define HEAP_STATS_MAX_TAGS   16
+
+#ifdef HEAP_STATS
+
+// Gắn tag cho mọi cấp phát của task hiện tại tới hết scope (lồng được).
+// tag phải là chuỗi hằng.
+class HeapTagScope
+{
+public:
+  explicit HeapTagScope(const char *tag);
+  ~HeapTagScope();
+
+private:
+  const char *_prev;
+};
+
+#define HEAP_TAG_CONCAT_(a, b)  a##b
+#define HEAP_TAG_CONCAT(a, b)   HEAP_TAG_CONCAT_(a, b)
+#define HEAP_TAG(tag)           HeapTagScope HEAP_TAG_CONCAT(_heapTag, __LINE__)(tag)
+
+// {"total":{...}, "tasks":[{"name",...}], "tags":[{"tag",...}]} cho /metrics
+void heapStatsToJson(JsonObject out);
+// Chỉ tổng: allocs / frees / allocBytes cho MQTT attributes
+void heapStatsSummaryToJson(JsonObject out);
+
+#else
+
+#define HEAP_TAG(tag)  ((void)0)
+
+#endif
+
+#endif
@@ -0,0 +1,63 @@
+#ifndef __I2C_BUS_H__
+#define __I2C_BUS_H__
+
+#include <Arduino.h>
+#include <Wire.h>
+#include "global.h"
+
+// Chân I2C chung cho DHT20 + LCD
+#define I2C_SDA_PIN  11
+#define I2C_SCL_PIN  12
+
+// DHT20 chạy được 400 kHz, PCF8574 của LCD chỉ đảm bảo 100 kHz
+#define I2C_BUS_FAST_HZ  400000
+#define I2C_BUS_STD_HZ   100000
+
+// Timeout cho mỗi thao tác Wire (ms) và số job lỗi liên tiếp có dấu hiệu treo
+// bus (SDA bị giữ thấp, Wire timeout / lỗi bus) trước khi gỡ bus. Lỗi NACK của
+// thiết bị vắng mặt không tính: bus vẫn rảnh, xung SCL không giúp được gì.
+#define I2C_BUS_WIRE_TIMEOUT_MS   20
+#define I2C_BUS_RECOVER_AFTER     2
+// Gỡ bus mà lỗi vẫn quay lại trước khi có job thành công → lần gỡ sau phải
+// chờ, khoảng chờ nhân đôi tới mức trần
+#define I2C_BUS_BACKOFF_MIN_MS    1000
+#define I2C_BUS_BACKOFF_MAX_MS    60000
+
+// Mã trả về của Wire.endTransmission() là lỗi bus (không phải NACK)
+#define I2C_WIRE_ERR_OTHER        4
+#define I2C_WIRE_ERR_TIMEOUT      5
+
+// Job chạy trong ngữ cảnh task bus, là nơi duy nhất được đụng tới Wire.
+// Trả về false nếu giao dịch lỗi (để bus manager thống kê; lỗi bus thật thì
+// báo thêm qua i2cBusNoteWireError để được gỡ bus).
+typedef bool (*I2cJobFn)(TwoWire &wire, void *arg);
+
+struct I2cBusStats {
+  uint32_t jobs;
+  uint32_t failures;
+  uint32_t timeouts;        // job quá hạn trước khi tới lượt chạy
+  uint32_t recoveries;      // số lần xung SCL gỡ bus
+  uint32_t recover_failed;  // gỡ xong SDA vẫn thấp / lỗi quay lại ngay
+  uint32_t max_job_us;
+  uint32_t max_wait_us;     // thời gian chờ trong hàng đợi lâu nhất
+};
+
+// Task sở hữu Wire: lấy job từ hàng đợi, chạy tuần tự, gỡ bus khi bị treo
+void i2c_bus_task(void *pvParameters);
+
+// Gửi job và chờ kết quả. Job nằm trong hàng đợi quá timeoutMs sẽ bị bỏ,
+// nên caller luôn được trả lời, kể cả khi một thiết bị khác treo bus.
+bool i2cBusRun(I2cJobFn fn, void *arg, uint32_t clockHz, uint32_t timeoutMs);
+
+// Giao dịch thô: ghi tx rồi (nếu rxLen > 0) đọc rx từ thiết bị addr
+bool i2cBusWriteRead(uint8_t addr, const uint8_t *tx, size_t txLen,
+                     uint8_t *rx, size_t rxLen,
+                     uint32_t clockHz, uint32_t timeoutMs);
+
+void i2cBusGetStats(I2cBusStats &out);
+
+// Gọi trong job với mã của endTransmission(): timeout / lỗi bus được đánh dấu
+// để bus manager gỡ bus sau job này
+void i2cBusNoteWireError(int err);
+
+#endif
@@ -0,0 +1,65 @@
+#ifndef __LATENCY_H__
+#define __LATENCY_H__
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+
+// Độ trễ đầu-cuối của mẫu: từ lúc DHT20 đọc xong (SensorSnapshot::acquired_us)
+// tới lúc giá trị ra tới từng sink. Đơn vị us, mốc là esp_timer_get_time().
+
+// Bucket log2: bucket k gom [2^k, 2^(k+1)) us, bucket 0 gồm cả 0.
+// 32 bucket phủ hết uint32_t nên không có giá trị nào rơi ra ngoài dải.
+#define LATENCY_BUCKETS  32
+
+struct LatencySummary {
+  uint32_t count;
+  uint32_t p50;
+  uint32_t p99;
+  uint32_t max;
+};
+
+// Histogram cố định trong struct, không cấp phát. Một task record(),
+// task khác đọc qua summary() / toJson() (bảo vệ bằng portMUX).
+class LatencyHistogram
+{
+public:
+  LatencyHistogram();
+
+  void record(uint32_t us);
+
+  // count / p50 / p99 / max (us), tính từ lúc boot, từ một ảnh nhất quán.
+  // Phân vị là cận trên của bucket chứa nó, không vượt quá max đã gặp.
+  void summary(LatencySummary &out);
+  void toJson(JsonObject out);
+
+private:
+  struct Snapshot {
+    uint32_t count;
+    uint32_t max;
+    uint32_t hist[LATENCY_BUCKETS];
+  };
+
+  void snapshot(Snapshot &out);
+  static uint32_t percentileOf(const Snapshot &s, uint8_t pct);
+
+  Snapshot     _data;
+  portMUX_TYPE _mux;
+};
+
+// Điểm đo trên đường đi của mẫu
+enum LatencySink : uint8_t {
+  LATENCY_SINK_WS = 0,    // frame telemetry gửi lên WebSocket
+  LATENCY_SINK_MQTT,      // telemetry ghi xong lên socket MQTT (gồm cả chờ lượt gửi)
+  LATENCY_SINK_LCD,       // LCD flush xong
+  LATENCY_SINK_COUNT
+};
+
+// Ghi độ trễ = bây giờ - acquiredUs vào histogram của sink
+void latencyRecord(LatencySink sink, uint32_t acquiredUs);
+
+// Lồng nhau cho /metrics: {"ws":{"count":..,"p50":..,"p99":..,"max":..}, ...}
+void latencyToJson(JsonObject out);
+// Phẳng cho MQTT attributes: wsP50, wsP99, wsMax, mqttP50, ...
+void latencySummaryToJson(JsonObject out);
+
+#endif
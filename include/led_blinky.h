@@ -5,6 +5,7 @@
 
 #define LED_GPIO 48
 
-void led_blinky(void *pvParameters);
+// Đăng ký job LED nhiệt độ trên executor (gọi trong setup)
+void led_blinky_init();
 
 #endif
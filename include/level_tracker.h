@@ -0,0 +1,51 @@
+#ifndef __LEVEL_TRACKER_H__
+#define __LEVEL_TRACKER_H__
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include "fixed_point.h"
+
+// Mức 3 bậc dùng chung cho nhiệt (LẠNH/BÌNH THƯỜNG/NÓNG) và ẩm (KHÔ/OK/ẨM):
+// TempLevel và HumiLevel cùng thứ tự thấp → cao.
+#define LEVEL_LOW   0
+#define LEVEL_MID   1
+#define LEVEL_HIGH  2
+
+struct LevelTrackerStats {
+  uint8_t  level;
+  uint32_t transitions;     // số lần đổi mức thật sự (mỗi lần = 1 LEVEL_CHANGE)
+  uint32_t held_hyst;       // mẫu vượt ngưỡng thô nhưng còn trong dải hysteresis
+  uint32_t held_dwell;      // mẫu đòi đổi mức nhưng chưa đủ thời gian dừng
+  uint32_t since_ms;        // lúc vào mức hiện tại
+};
+
+// Phân loại có hysteresis + thời gian dừng tối thiểu, chống nhấp nháy ở sát ngưỡng:
+//  - Vào mức thấp/cao ngay khi vượt ngưỡng (< low, > high) như trước;
+//    về mức giữa phải qua ngưỡng thêm `hysteresis` (>= low + h, <= high - h).
+//  - Mức mới phải giữ liên tục dwellMs mới được chấp nhận (0 = ngay).
+// Chỉ một task gọi update(); getStats() / toJson() gọi được từ task khác.
+class LevelTracker
+{
+public:
+  explicit LevelTracker(uint8_t initial);
+
+  // Mọi giá trị ở đơn vị centi (0.01). Trả về mức sau khi lọc.
+  uint8_t update(centi_t value, centi_t low, centi_t high, centi_t hysteresis,
+                 uint32_t dwellMs, uint32_t nowMs);
+
+  uint8_t level() const { return _level; }
+  void getStats(LevelTrackerStats &out);
+  void toJson(JsonObject out);
+
+private:
+  uint8_t candidate(centi_t value, centi_t low, centi_t high, centi_t hysteresis,
+                    bool &heldByHysteresis) const;
+
+  uint8_t           _level;
+  uint8_t           _pending;        // mức đang chờ đủ dwell
+  uint32_t          _pendingSince;
+  LevelTrackerStats _stats;
+  portMUX_TYPE      _mux;
+};
+
+#endif
@@ -0,0 +1,173 @@
+#ifndef __LOGGER_H__
+#define __LOGGER_H__
+
+#include <Arduino.h>
+#include <atomic>
+#include <type_traits>
+#include "global.h"
+
+// Log bất đồng bộ: producer chỉ ghi record nhị phân (con trỏ format + tham số
+// đã mã hoá) vào ring; task log_drain_task ưu tiên thấp mới format và đẩy ra
+// UART / USB-CDC. Producer không bao giờ chờ Serial: ring đầy thì record bị
+// bỏ và đếm vào METRIC_LOG_DROPPED.
+//
+//   LOGI(SENSOR, "H: %s%%  T: %s C", humiText, tempText);
+//
+// - fmt phải là chuỗi hằng (chỉ lưu con trỏ). Không hỗ trợ '*' trong width.
+// - Chuỗi (%s, kể cả String) được chép vào record, quá dài thì bị cắt.
+// - Gọi được từ ISR.
+
+// ====== Mức log ======
+#define LOG_LEVEL_NONE   0
+#define LOG_LEVEL_ERROR  1
+#define LOG_LEVEL_WARN   2
+#define LOG_LEVEL_INFO   3
+#define LOG_LEVEL_DEBUG  4
+
+// Mức theo module, chốt lúc biên dịch: log dưới mức bị bỏ hẳn (không tính
+// tham số, không giữ chuỗi format). Đổi bằng build flag, ví dụ
+// -DLOG_LEVEL_WEB=LOG_LEVEL_DEBUG hoặc -DLOG_LEVEL_DEFAULT=LOG_LEVEL_WARN.
+#ifndef LOG_LEVEL_DEFAULT
+#define LOG_LEVEL_DEFAULT  LOG_LEVEL_INFO
+#endif
+#ifndef LOG_LEVEL_SENSOR
+#define LOG_LEVEL_SENSOR   LOG_LEVEL_DEFAULT
+#endif
+#ifndef LOG_LEVEL_ML
+#define LOG_LEVEL_ML       LOG_LEVEL_DEFAULT
+#endif
+#ifndef LOG_LEVEL_MQTT
+#define LOG_LEVEL_MQTT     LOG_LEVEL_DEFAULT
+#endif
+#ifndef LOG_LEVEL_WEB
+#define LOG_LEVEL_WEB      LOG_LEVEL_DEFAULT
+#endif
+#ifndef LOG_LEVEL_BUS
+#define LOG_LEVEL_BUS      LOG_LEVEL_DEFAULT
+#endif
+#ifndef LOG_LEVEL_SYS
+#define LOG_LEVEL_SYS      LOG_LEVEL_DEFAULT
+#endif
+
+enum LogModule : uint8_t {
+  LOG_MOD_SENSOR = 0,   // temp_humi_monitor
+  LOG_MOD_ML,           // tiny_ml_task
+  LOG_MOD_MQTT,         // coreiot_task
+  LOG_MOD_WEB,          // WebSocket / WebUI
+  LOG_MOD_BUS,          // I2C bus manager, RS485
+  LOG_MOD_SYS,          // WiFi, supervisor, cấu hình, nút BOOT
+  LOG_MOD_COUNT
+};
+
+#define LOG_AT(mod, lvl, fmt, ...) \
+  do { \
+    if ((lvl) <= LOG_LEVEL_##mod) \
+      logWrite(LOG_MOD_##mod, (lvl), fmt, ##__VA_ARGS__); \
+  } while (0)
+
+#define LOGE(mod, fmt, ...)  LOG_AT(mod, LOG_LEVEL_ERROR, fmt, ##__VA_ARGS__)
+#define LOGW(mod, fmt, ...)  LOG_AT(mod, LOG_LEVEL_WARN,  fmt, ##__VA_ARGS__)
+#define LOGI(mod, fmt, ...)  LOG_AT(mod, LOG_LEVEL_INFO,  fmt, ##__VA_ARGS__)
+#define LOGD(mod, fmt, ...)  LOG_AT(mod, LOG_LEVEL_DEBUG, fmt, ##__VA_ARGS__)
+
+// ====== Record ======
+// Số record trong ring (lũy thừa của 2) và byte tham số tối đa mỗi record
+#ifndef LOG_RING_RECORDS
+#define LOG_RING_RECORDS   64
+#endif
+#define LOG_PAYLOAD_BYTES  56
+
+// Tham số được mã hoá: 1 byte kiểu + giá trị; chuỗi là 1 byte độ dài + các ký tự
+enum LogArgType : uint8_t {
+  LOG_ARG_I32 = 0,
+  LOG_ARG_U32,
+  LOG_ARG_I64,
+  LOG_ARG_DOUBLE,
+  LOG_ARG_STR
+};
+
+struct LogRecord {
+  std::atomic<uint32_t> seq;    // index + 1 khi đã ghi xong
+  const char *fmt;
+  uint32_t    timeMs;
+  uint8_t     module;
+  uint8_t     level;
+  uint8_t     len;              // byte payload đã dùng
+  uint8_t     truncated;        // có tham số bị bỏ / chuỗi bị cắt
+  uint8_t     payload[LOG_PAYLOAD_BYTES];
+};
+
+// Ghi tham số vào record đã được cấp; chỉ dùng qua logWrite()
+class LogWriter
+{
+public:
+  LogWriter(LogRecord *rec, uint32_t index) : _rec(rec), _index(index) { rec->len = 0; rec->truncated = 0; }
+
+  void putI32(int32_t v)   { putRaw(LOG_ARG_I32, &v, sizeof(v)); }
+  void putU32(uint32_t v)  { putRaw(LOG_ARG_U32, &v, sizeof(v)); }
+  void putI64(int64_t v)   { putRaw(LOG_ARG_I64, &v, sizeof(v)); }
+  void putDouble(double v) { putRaw(LOG_ARG_DOUBLE, &v, sizeof(v)); }
+  void putStr(const char *s);
+
+  void commit(uint8_t module, uint8_t level, const char *fmt);
+
+private:
+  void putRaw(uint8_t type, const void *data, uint8_t size);
+
+  LogRecord *_rec;
+  uint32_t   _index;
+};
+
+// Cấp một ô trong ring; false nếu ring đầy (record bị bỏ, đã đếm)
+bool logReserve(LogRecord *&rec, uint32_t &index);
+
+// ====== Mã hoá tham số theo kiểu ======
+template <typename T>
+inline typename std::enable_if<std::is_integral<T>::value || std::is_enum<T>::value>::type
+logPut(LogWriter &w, T v)
+{
+  if (sizeof(T) > 4)
+    w.putI64((int64_t)v);
+  else if (std::is_signed<T>::value)
+    w.putI32((int32_t)v);
+  else
+    w.putU32((uint32_t)v);
+}
+
+inline void logPut(LogWriter &w, double v)        { w.putDouble(v); }
+inline void logPut(LogWriter &w, const char *s)   { w.putStr(s); }
+inline void logPut(LogWriter &w, char *s)         { w.putStr(s); }
+inline void logPut(LogWriter &w, const String &s) { w.putStr(s.c_str()); }
+
+template <typename T>
+inline void logPut(LogWriter &w, T *p) { w.putU32((uint32_t)(uintptr_t)p); }
+
+inline void logPutAll(LogWriter &w) { (void)w; }
+
+template <typename T, typename... Rest>
+inline void logPutAll(LogWriter &w, const T &first, const Rest &... rest)
+{
+  logPut(w, first);
+  logPutAll(w, rest...);
+}
+
+template <typename... Args>
+void logWrite(uint8_t module, uint8_t level, const char *fmt, const Args &... args)
+{
+  LogRecord *rec;
+  uint32_t index;
+  if (!logReserve(rec, index))
+    return;
+  LogWriter w(rec, index);
+  logPutAll(w, args...);
+  w.commit(module, level, fmt);
+}
+
+// Task format + in record, tạo trong task_table (ưu tiên thấp nhất)
+void log_drain_task(void *pvParameters);
+
+// Chờ drain task in hết record đang có, tối đa timeoutMs; gọi trước
+// ESP.restart() để dòng log cuối không bị mất
+void logFlush(uint32_t timeoutMs);
+
+#endif
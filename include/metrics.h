@@ -0,0 +1,42 @@
+#ifndef __METRICS_H__
+#define __METRICS_H__
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <atomic>
+#include "global.h"
+
+// Bộ đếm theo subsystem: chỉ là atomic fetch_add, để bật thường trực được.
+// Mọi thứ khác (heap, stack, CPU) chỉ được gom khi có người hỏi.
+enum MetricCounter : uint8_t {
+  METRIC_SENSOR_SAMPLES = 0,   // mẫu DHT20 được phát
+  METRIC_SENSOR_ERRORS,        // chu kỳ đọc lỗi
+  METRIC_INFERENCES,           // lần suy luận TinyML
+  METRIC_MQTT_PUBLISHES,       // telemetry / attributes gửi thành công
+  METRIC_MQTT_FAILURES,
+  METRIC_MQTT_RPC,             // RPC nhận từ CoreIoT
+  METRIC_WS_FRAMES,            // frame WebSocket gửi đi (mọi client tính 1)
+  METRIC_LOG_RECORDS,          // record log đã vào ring
+  METRIC_LOG_DROPPED,          // record log bị bỏ vì ring đầy
+  METRIC_COUNT
+};
+
+// Chu kỳ coreiot_task gửi tóm tắt metrics lên attributes
+#define METRICS_MQTT_PERIOD_MS  60000
+
+extern std::atomic<uint32_t> metricCounters[METRIC_COUNT];
+
+inline void metricInc(MetricCounter id, uint32_t n = 1)
+{
+  metricCounters[id].fetch_add(n, std::memory_order_relaxed);
+}
+
+// Đầy đủ: uptime, heap + phân mảnh, bộ đếm, độ trễ theo sink, event bus,
+// CPU / stack từng task (dùng cho /metrics và trang dashboard).
+// Build với HEAP_STATS có thêm "alloc": cấp phát theo task / tag (heap_stats.h).
+void metricsToJson(JsonObject out);
+
+// Tóm tắt phẳng cho MQTT attributes (heap, tải core, bộ đếm, p50/p99/max độ trễ)
+void metricsSummaryToJson(JsonObject out);
+
+#endif
@@ -6,6 +6,7 @@
 #define NEO_PIN 45
 #define LED_COUNT 1 
 
-void neo_blinky(void *pvParameters);
+// Đăng ký job NeoPixel độ ẩm trên executor (gọi trong setup)
+void neo_blinky_init();
 
 #endif
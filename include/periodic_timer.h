@@ -0,0 +1,55 @@
+#ifndef __PERIODIC_TIMER_H__
+#define __PERIODIC_TIMER_H__
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include "global.h"
+
+// Histogram độ lệch chu kỳ: bucket 0 = < 128 us, bucket k = [128·2^(k-1), 128·2^k) us,
+// bucket cuối gom mọi giá trị lớn hơn (~262 ms trở lên)
+#define PERIODIC_HIST_BUCKETS  12
+#define PERIODIC_HIST_BASE_US  128
+
+// Lịch chạy tuần hoàn theo deadline tuyệt đối (xTaskDelayUntil):
+// thời gian xử lý trong thân vòng lặp không làm trôi chu kỳ lấy mẫu.
+// Mỗi timer tự đăng ký vào danh sách chung để xuất thống kê jitter.
+class PeriodicTimer
+{
+public:
+  PeriodicTimer(const char *name, uint32_t periodMs);
+
+  // Ngủ tới deadline kế tiếp. Trả về false nếu deadline đã bị lỡ
+  // (thân vòng lặp dài hơn chu kỳ); khi đó lịch được đặt lại từ hiện tại.
+  bool wait();
+
+  // Đổi chu kỳ, áp dụng từ deadline kế tiếp
+  void setPeriod(uint32_t periodMs);
+  uint32_t period() const { return _periodMs; }
+
+  const char *name() const { return _name; }
+  uint32_t cycles() const { return _cycles; }
+  uint32_t missed() const { return _missed; }
+  uint32_t maxJitterUs() const { return _maxJitterUs; }
+  const uint32_t *histogram() const { return _hist; }
+
+  // Ghi thống kê của mọi timer đã tạo vào mảng JSON
+  static void statsToJson(JsonArray out);
+
+private:
+  void record(uint32_t jitterUs);
+
+  const char   *_name;
+  uint32_t      _periodMs;
+  TickType_t    _lastWake;
+  int64_t       _lastWakeUs;
+
+  uint32_t      _cycles;
+  uint32_t      _missed;
+  uint32_t      _maxJitterUs;
+  uint32_t      _hist[PERIODIC_HIST_BUCKETS];
+
+  PeriodicTimer *_next;
+  static PeriodicTimer *_first;
+};
+
+#endif
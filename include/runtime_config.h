@@ -0,0 +1,45 @@
+#ifndef __RUNTIME_CONFIG_H__
+#define __RUNTIME_CONFIG_H__
+
+#include <Arduino.h>
+#include "global.h"
+
+// Cấu hình runtime chỉnh từ WebUI / RPC, có version.
+// Writer dựng bản mới ở buffer riêng rồi publish bằng MỘT lần đổi con trỏ atomic;
+// reader chép một ảnh nhất quán mỗi chu kỳ, không khoá.
+struct RuntimeConfig {
+  uint32_t       version;          // tăng mỗi lần commit, bắt đầu từ 1
+
+  // Ngưỡng nhiệt / ẩm
+  float          tempCold;
+  float          tempHot;
+  float          humiDry;
+  float          humiHumid;
+
+  // Chống nhấp nháy mức ở sát ngưỡng (xem level_tracker.h)
+  float          tempHysteresis;   // °C
+  float          humiHysteresis;   // %RH
+  uint32_t       levelDwellMs;     // mức mới phải giữ ít nhất chừng này
+
+  TempLedConfig  tempLed[3];       // theo TempLevel
+  NeoColorConfig neoColor[3];      // theo HumiLevel
+
+  // Bật/tắt LED từ WebUI / RPC
+  bool           tempLedEnabled;
+  bool           humiLedEnabled;
+};
+
+// Dựng bản mặc định, gọi 1 lần đầu setup() trước mọi reader / writer
+void runtimeConfigBegin();
+
+// Chép bản hiện tại vào out nếu version khác lastVersion; trả về true khi có chép.
+// lastVersion = 0 luôn chép. Không khoá, an toàn từ mọi task.
+bool runtimeConfigRead(RuntimeConfig &out, uint32_t lastVersion = 0);
+uint32_t runtimeConfigVersion();
+
+// Writer: lấy bản nháp (chép từ bản hiện tại), sửa, rồi commit.
+// Giữ mutex writer từ edit tới commit; không gọi từ ISR.
+RuntimeConfig &runtimeConfigEdit();
+uint32_t runtimeConfigCommit();   // publish bản nháp, trả về version mới
+
+#endif
@@ -0,0 +1,68 @@
+#ifndef __SENSOR_FILTER_H__
+#define __SENSOR_FILTER_H__
+
+#include <Arduino.h>
+#include "global.h"
+#include "fixed_point.h"
+#include "DHT20.h"
+
+// Số lần đo tối đa trong 1 chu kỳ
+#define SENSOR_FILTER_MAX_OVERSAMPLE  9
+
+// Khoảng cách giữa hai lần đo liên tiếp (ms, từ lần đọc trước tới lần kích
+// kế tiếp). Không thấp hơn khoảng tối thiểu của DHT20: đo dồn dập làm cảm
+// biến tự nóng lên.
+#define SENSOR_FILTER_MIN_SPACING_MS  DHT20_MIN_INTERVAL_MS
+#define SENSOR_FILTER_MAX_SPACING_MS  10000
+
+enum SensorFilterMode : uint8_t {
+  SENSOR_FILTER_NONE = 0,   // trung bình các lần đo trong chu kỳ
+  SENSOR_FILTER_MEDIAN,     // trung vị của N lần đo (loại spike đơn lẻ)
+  SENSOR_FILTER_EWMA,       // trung bình trượt hàm mũ qua các chu kỳ
+  SENSOR_FILTER_KALMAN      // Kalman 1-D, mô hình giá trị gần như hằng
+};
+
+struct SensorFilterConfig {
+  uint8_t mode;             // SensorFilterMode
+  uint8_t oversample;       // 1..SENSOR_FILTER_MAX_OVERSAMPLE
+  uint16_t spacing_ms;      // SENSOR_FILTER_MIN_SPACING_MS..SENSOR_FILTER_MAX_SPACING_MS
+  float   ewma_alpha;       // 0..1, lớn = bám nhanh
+  float   kalman_q;         // nhiễu quá trình
+  float   kalman_r;         // nhiễu đo
+  int32_t ewma_alpha_q16;   // ewma_alpha dạng Q16, tính sẵn khi đặt cấu hình
+};
+
+// Bộ lọc cho 1 kênh (nhiệt hoặc ẩm). Trạng thái nằm trong object,
+// không cấp phát động; chỉ temp_humi_monitor gọi update().
+class SensorFilter
+{
+public:
+  SensorFilter();
+
+  void reset();
+
+  // Lọc n mẫu của chu kỳ hiện tại, trả về giá trị sẽ publish
+  float update(const float *samples, uint8_t n, const SensorFilterConfig &cfg);
+
+  // Bản số nguyên (0.01 đơn vị) cho SENSOR_FIXED_POINT. Trung bình, median
+  // và EWMA (Q8) chạy hoàn toàn bằng số nguyên; Kalman vẫn tính bằng float.
+  centi_t update(const centi_t *samples, uint8_t n, const SensorFilterConfig &cfg);
+
+private:
+  bool    _primed;
+  float   _estimate;
+  float   _variance;        // hiệp phương sai ước lượng (Kalman)
+  int32_t _estimateQ8;      // ước lượng EWMA nguyên, centi << 8
+};
+
+// Cấu hình runtime, chỉnh từ WebUI (trang "threshold")
+void sensorFilterSetConfig(const SensorFilterConfig &cfg);
+
+// Lấy bản sao cấu hình. Trả về true nếu cấu hình đã đổi kể từ lastGeneration
+// (caller nên reset trạng thái bộ lọc), generation được cập nhật vào tham số.
+bool sensorFilterGetConfig(SensorFilterConfig &out, uint32_t &generation);
+
+const char *sensorFilterModeName(uint8_t mode);
+uint8_t sensorFilterModeFromName(const String &name, uint8_t fallback);
+
+#endif
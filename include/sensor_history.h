@@ -0,0 +1,103 @@
+#ifndef __SENSOR_HISTORY_H__
+#define __SENSOR_HISTORY_H__
+
+#include <Arduino.h>
+#include <atomic>
+#include "fixed_point.h"
+
+// Số mẫu giữ trong RAM: 3600 mẫu x 2 s = 2 giờ lịch sử (~28 KB)
+#ifndef SENSOR_HISTORY_CAPACITY
+#define SENSOR_HISTORY_CAPACITY 3600
+#endif
+
+// Một mẫu đã giải nén từ ring buffer
+struct HistorySample {
+  uint32_t timestamp_ms;
+  int16_t  temp_centi;     // 0.01 °C
+  uint16_t humi_centi;     // 0.01 %RH
+
+  float temperature() const { return temp_centi * 0.01f; }
+  float humidity() const    { return humi_centi * 0.01f; }
+};
+
+// Ring buffer lịch sử mẫu, layout struct-of-arrays.
+// Một writer (temp_humi_monitor), nhiều reader, không khoá:
+// reader kiểm tra lại con trỏ head sau khi đọc để phát hiện slot bị ghi đè.
+class SensorHistory
+{
+public:
+  class Iterator
+  {
+  public:
+    Iterator(const SensorHistory *history, uint32_t index, uint32_t end);
+
+    const HistorySample &operator*() const { return _sample; }
+    const HistorySample *operator->() const { return &_sample; }
+    Iterator &operator++();
+    bool operator!=(const Iterator &other) const { return _index != other._index; }
+
+    // Chỉ số tuyệt đối (tăng dần từ lúc khởi động) của mẫu hiện tại
+    uint32_t index() const { return _index; }
+
+  private:
+    void load();
+
+    const SensorHistory *_history;
+    uint32_t _index;
+    uint32_t _end;
+    HistorySample _sample;
+  };
+
+  // Khoảng [first, last) theo chỉ số tuyệt đối, duyệt bằng range-for
+  class Range
+  {
+  public:
+    Range(const SensorHistory *history, uint32_t first, uint32_t last)
+      : _history(history), _first(first), _last(last) {}
+
+    Iterator begin() const { return Iterator(_history, _first, _last); }
+    Iterator end() const   { return Iterator(_history, _last, _last); }
+    uint32_t size() const  { return _last - _first; }
+
+  private:
+    const SensorHistory *_history;
+    uint32_t _first;
+    uint32_t _last;
+  };
+
+  SensorHistory();
+
+  // Ghi một mẫu mới (chỉ gọi từ writer duy nhất)
+  void push(uint32_t timestampMs, float temperature, float humidity);
+  // Như push() nhưng nhận sẵn giá trị 0.01 đơn vị, không đi qua float
+  void pushCenti(uint32_t timestampMs, centi_t temperature, centi_t humidity);
+
+  // Tổng số mẫu đã ghi từ lúc khởi động
+  uint32_t head() const { return _head.load(std::memory_order_acquire); }
+  // Số mẫu còn giữ trong buffer
+  uint32_t size() const;
+  uint32_t capacity() const { return SENSOR_HISTORY_CAPACITY; }
+
+  // Đọc mẫu theo chỉ số tuyệt đối; false nếu chưa ghi hoặc đã bị ghi đè
+  bool read(uint32_t index, HistorySample &out) const;
+
+  // n mẫu mới nhất
+  Range latest(uint32_t n) const;
+  // Các mẫu có timestamp >= sinceMs
+  Range since(uint32_t sinceMs) const;
+  // Các mẫu có chỉ số tuyệt đối >= index; consumer lưu lại head()
+  // sau mỗi lần đọc để lần sau chỉ duyệt phần mới
+  Range from(uint32_t index) const;
+
+private:
+  uint32_t oldestIndex(uint32_t head) const;
+
+  uint32_t _timestamp[SENSOR_HISTORY_CAPACITY];
+  int16_t  _temp[SENSOR_HISTORY_CAPACITY];
+  uint16_t _humi[SENSOR_HISTORY_CAPACITY];
+  std::atomic<uint32_t> _head;
+};
+
+extern SensorHistory sensorHistory;
+
+#endif
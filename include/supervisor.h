@@ -0,0 +1,28 @@
+#ifndef __SUPERVISOR_H__
+#define __SUPERVISOR_H__
+
+#include <Arduino.h>
+#include "global.h"
+#include "freertos/event_groups.h"
+
+// Supervisor thay cho loop() quay liên tục: loop() ngủ trên một event group
+// và chỉ khởi động lại thành phần khi có bit tương ứng được đặt.
+#define SUP_WIFI_UP         (1UL << 0)   // STA có IP
+#define SUP_WIFI_DOWN       (1UL << 1)   // STA mất kết nối / mất IP
+#define SUP_WEB_STOPPED     (1UL << 2)   // Webserver_stop() được gọi
+#define SUP_OTA_DONE        (1UL << 3)   // OTA ghi xong firmware
+#define SUP_OTA_REBOOT      (1UL << 4)   // hết thời gian chờ trả lời HTTP, restart
+#define SUP_ALL_BITS        0x1FUL
+// Lưu cấu hình WiFi / CoreIoT (Save_info_File) vẫn restart nên không cần bit riêng
+
+// Tạo event group, đăng ký WiFi.onEvent và callback OTA.
+// Gọi trong setup() sau timerWheelBegin().
+void supervisorBegin();
+
+// Báo supervisor (task context)
+void supervisorSignal(EventBits_t bits);
+
+// Chờ tới khi có bit rồi xử lý; gọi từ loop(), không trả về khi không có việc
+void supervisorRun();
+
+#endif
@@ -0,0 +1,59 @@
+#ifndef __TASK_TABLE_H__
+#define __TASK_TABLE_H__
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include "global.h"
+
+// Phân core: WiFi / lwIP / AsyncTCP chạy trên core 0 (PRO_CPU),
+// đọc cảm biến + TinyML trên core 1 (APP_CPU) cùng loopTask của Arduino
+#define CORE_NETWORK  0
+#define CORE_SENSING  1
+
+// Diagnostic stack: build với -DTASK_STACK_DIAG để có task in định kỳ
+// stack đã dùng (high-water mark) và kích thước đề xuất của từng task
+#ifndef TASK_STACK_DIAG_PERIOD_MS
+#define TASK_STACK_DIAG_PERIOD_MS  30000
+#endif
+// Đề xuất = stack đã dùng + 25% (tối thiểu 512 byte), làm tròn lên 256 byte
+#define TASK_STACK_HEADROOM_MIN    512
+#define TASK_STACK_ROUND           256
+
+// Một dòng trong bảng task: tạo bằng xTaskCreateStaticPinnedToCore,
+// stack và TCB nằm trong .bss nên không xé nhỏ heap lúc boot
+struct TaskSpec {
+  TaskFunction_t fn;
+  const char    *name;
+  uint32_t       stack;      // byte (ESP32)
+  UBaseType_t    priority;
+  BaseType_t     core;       // CORE_NETWORK / CORE_SENSING
+  StackType_t   *stackBuf;
+  StaticTask_t  *tcb;
+};
+
+// Khai báo bộ nhớ tĩnh cho một task: <id>Stack[bytes] và <id>Tcb
+#define TASK_STATIC_STORAGE(id, bytes) \
+  static StackType_t  id##Stack[bytes]; \
+  static StaticTask_t id##Tcb
+
+// Tạo mọi task trong bảng, gọi 1 lần trong setup()
+void startTaskTable();
+
+// Mốc của lần báo cáo trước; mỗi consumer (WebUI, /metrics, MQTT) giữ một
+// cửa sổ riêng để không rút ngắn cửa sổ của nhau
+struct TaskLoadWindow {
+  uint32_t total;
+  uint32_t idle[portNUM_PROCESSORS];
+};
+
+// Thống kê theo core và theo task (mọi task của hệ thống, kể cả WiFi/AsyncTCP).
+// Tải mỗi core tính theo thời gian chạy của idle task kể từ lần gọi trước
+// với cùng window, chỉ có khi FreeRTOS bật configGENERATE_RUN_TIME_STATS.
+// withTasks = false: chỉ tải core, bỏ mảng task.
+void taskLoadToJson(JsonObject out, TaskLoadWindow &window, bool withTasks = true);
+
+// Stack đã dùng và kích thước đề xuất của các task trong bảng
+void taskStackToJson(JsonArray out);
+void taskStackPrint();
+
+#endif
@@ -3,4 +3,5 @@
 #include "global.h"
 #include "task_check_info.h"
 
-void Task_Toogle_BOOT(void *pvParameters);
\ No newline at end of file
+// Đăng ký job đọc nút BOOT trên executor (gọi trong setup)
+void Task_Toogle_BOOT_init();
\ No newline at end of file
@@ -8,6 +8,7 @@
 #include <ArduinoJson.h>
 #include <ElegantOTA.h>
 #include <task_handler.h>
+#include "telemetry_encoder.h"
 
 extern AsyncWebServer server;
 extern AsyncWebSocket ws;
@@ -15,5 +16,9 @@ extern AsyncWebSocket ws;
 void Webserver_stop();
 void Webserver_reconnect();
 void Webserver_sendata(String data);
+// Gửi frame telemetry đã encode sẵn, chỉ thêm envelope "page"
+void Webserver_sendata(const TelemetryFrame &frame);
+// Đăng ký nhận frame telemetry (mẫu cảm biến + TinyML) để đẩy lên WebSocket
+void Webserver_subscribeEvents();
 
 #endif
\ No newline at end of file
@@ -5,7 +5,10 @@
 #include <task_check_info.h>
 #include <task_webserver.h>
 
-extern bool Wifi_reconnect();
+// Đăng ký coroutine kết nối / giữ kết nối WiFi STA trên executor
+extern void Wifi_init();
+// Báo coroutine WiFi kiểm tra lại trạng thái (gọi khi có sự kiện WiFi)
+extern void Wifi_notify();
 extern void startAP();
 
 #endif
\ No newline at end of file
@@ -0,0 +1,42 @@
+#ifndef __TELEMETRY_ENCODER_H__
+#define __TELEMETRY_ENCODER_H__
+
+#include <Arduino.h>
+#include "global.h"
+
+// latest + 1 bản MQTT đang gửi + 2 bản đang encode (mẫu và kết quả TinyML
+// được encode trong hai task khác nhau)
+#define TELEMETRY_FRAME_POOL   4
+#define TELEMETRY_BODY_MAX     160
+#define TELEMETRY_MAX_SINKS    2
+
+// Một mẫu đã serialize sẵn. Mỗi mẫu cho 2 frame: ngay khi đọc xong (chỉ
+// cảm biến), rồi khi TinyML suy luận xong trên CHÍNH mẫu đó (cảm biến + kết
+// quả). Kết quả TinyML không bao giờ đi kèm giá trị của mẫu khác.
+// body là phần thân JSON KHÔNG có ngoặc nhọn, ví dụ:
+//   "temperature":25.31,"humidity":61.20,"tiny_score":0.042,...
+// Mỗi sink tự thêm envelope của mình ({"page":"telemetry",  ...  } hoặc { ... }).
+struct TelemetryFrame {
+  uint8_t  refs;             // chỉ đọc/ghi dưới telemetryMux
+  uint32_t seq;              // tăng mỗi frame
+  uint32_t sample_seq;       // SensorSnapshot::seq của mẫu trong frame
+  bool     with_ml;          // frame thứ 2 của mẫu, có kết quả TinyML
+  uint32_t acquired_us;      // SensorSnapshot::acquired_us của mẫu, đo độ trễ ở sink
+  uint16_t len;
+  char     body[TELEMETRY_BODY_MAX];
+};
+
+// Sink được gọi đồng bộ ngay sau khi encode (trong task của temp_humi_monitor
+// hoặc của TinyML), frame chỉ hợp lệ trong thời gian gọi
+typedef void (*TelemetrySink)(const TelemetryFrame &frame);
+
+// Đăng ký với event bus, gọi sau eventBusBegin()
+void telemetryEncoderBegin();
+bool telemetryAddSink(TelemetrySink sink);
+
+// Lấy frame mới nhất (+1 ref), nullptr nếu chưa có mẫu nào.
+// Phải trả lại bằng telemetryRelease().
+TelemetryFrame *telemetryAcquireLatest();
+void telemetryRelease(TelemetryFrame *frame);
+
+#endif
@@ -2,9 +2,14 @@
 #define __TEMP_HUMI_MONITOR__
 #include <Arduino.h>
 #include "LiquidCrystal_I2C.h"
+#include "LcdFrameBuffer.h"
 #include "DHT20.h"
 #include "global.h"
+#include <ArduinoJson.h>
 
 void temp_humi_monitor(void *pvParameters);
 
+// Mức hiện tại + số lần đổi mức / số mẫu bị hysteresis, dwell giữ lại
+void levelStatsToJson(JsonObject out);
+
 #endif
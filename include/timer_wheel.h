@@ -0,0 +1,55 @@
+#ifndef __TIMER_WHEEL_H__
+#define __TIMER_WHEEL_H__
+
+#include <Arduino.h>
+#include "global.h"
+
+// Timer wheel phân cấp dùng chung, chạy trên MỘT esp_timer one-shot:
+// esp_timer chỉ được hẹn tới tick có việc kế tiếp, giữa 2 deadline không tốn gì.
+//   tầng 0: 256 ô × 10 ms   (2.56 s)
+//   tầng 1:  64 ô × 2.56 s  (~2.7 phút)
+//   tầng 2:  64 ô × 164 s   (~2.9 giờ); xa hơn được xếp lại khi tới lượt
+#define TIMER_WHEEL_TICK_MS  10
+#define TIMER_WHEEL_BATCH    16   // số timer gom lại rồi mới dispatch (ngoài critical section)
+
+// Callback chạy trong task esp_timer: phải ngắn, không block
+// (thường chỉ đặt cờ / notify / gửi queue)
+typedef void (*WheelTimerFn)(void *ctx);
+
+enum WheelTimerKind : uint8_t {
+  WHEEL_TIMER_CALLBACK = 0,
+  WHEEL_TIMER_QUEUE,         // xQueueSend(queue, &item, 0)
+  WHEEL_TIMER_NOTIFY         // xTaskNotify(task, bits, eSetBits)
+};
+
+// Bộ nhớ của timer do caller giữ (thường là static), wheel chỉ nối con trỏ.
+// Các field là nội bộ, chỉ dùng qua hàm bên dưới.
+struct WheelTimer {
+  WheelTimer   *next;
+  WheelTimer  **pprev;       // trỏ tới con trỏ đang trỏ vào timer: huỷ O(1)
+  uint32_t      expires;     // tick tuyệt đối
+  uint32_t      period;      // tick, 0 = one-shot
+  uint8_t       level;
+  uint8_t       kind;        // WheelTimerKind
+  union {
+    struct { WheelTimerFn fn; void *ctx; } callback;
+    struct { QueueHandle_t queue; uint32_t item; } queue;
+    struct { TaskHandle_t task; uint32_t bits; } notify;
+  } target;
+};
+
+// Tạo esp_timer, gọi 1 lần trong setup() trước khi dùng timer
+void timerWheelBegin();
+
+// Khởi tạo timer với cách dispatch khi tới hạn
+void wheelTimerInitCallback(WheelTimer &t, WheelTimerFn fn, void *ctx);
+void wheelTimerInitQueue(WheelTimer &t, QueueHandle_t queue, uint32_t item);
+void wheelTimerInitNotify(WheelTimer &t, TaskHandle_t task, uint32_t bits);
+
+// Hẹn (hoặc hẹn lại nếu đang chạy) sau delayMs, lặp mỗi periodMs nếu > 0. O(1).
+void wheelTimerStart(WheelTimer &t, uint32_t delayMs, uint32_t periodMs = 0);
+// Huỷ, O(1). Timer vừa tới hạn có thể vẫn được dispatch thêm 1 lần.
+void wheelTimerCancel(WheelTimer &t);
+bool wheelTimerActive(const WheelTimer &t);
+
+#endif
@@ -0,0 +1,105 @@
+#ifndef __TRACE_H__
+#define __TRACE_H__
+
+#include <Arduino.h>
+#include "global.h"
+
+// Trace sự kiện begin / end / instant, gắn task + core, xuất dạng Chrome trace
+// JSON (mở bằng chrome://tracing hoặc ui.perfetto.dev) qua GET /trace.
+// Chỉ có khi build với -DTRACE_ENABLED (env yolo_uno_trace); không bật thì
+// mọi macro TRACE_* rỗng, không tốn byte code hay RAM nào.
+//
+// Tên sự kiện phải là chuỗi hằng (literal): buffer chỉ lưu con trỏ,
+// và khi xuất không escape nên tránh dấu nháy / gạch chéo ngược.
+
+// Số sự kiện giữ lại cho MỖI core; đầy thì ghi đè sự kiện cũ nhất
+#ifndef TRACE_BUFFER_EVENTS
+#define TRACE_BUFFER_EVENTS  512
+#endif
+
+#ifdef TRACE_ENABLED
+
+enum TracePhase : uint8_t {
+  TRACE_PHASE_BEGIN   = 'B',
+  TRACE_PHASE_END     = 'E',
+  TRACE_PHASE_INSTANT = 'i'
+};
+
+// Ghi một sự kiện vào ring của core hiện tại. Không khoá, gọi được từ ISR.
+void traceRecord(const char *name, TracePhase phase);
+
+// Một sự kiện đã chụp ra khỏi ring
+struct TraceEvent {
+  uint32_t     tsUs;    // 32 bit thấp của esp_timer_get_time()
+  const char  *name;
+  TaskHandle_t task;    // nullptr = ISR
+  uint8_t      phase;   // TracePhase
+  uint8_t      core;
+};
+
+// Ảnh chụp ring của mọi core + tên task tại lúc tạo, xuất dần dạng Chrome
+// trace JSON cho chunked response (không dựng cả file trong RAM).
+// Writer vẫn ghi trong lúc chụp; ô bị ghi đè giữa chừng được bỏ qua.
+class TraceExport
+{
+public:
+  TraceExport();
+  ~TraceExport();
+
+  bool ok() const { return _events != nullptr; }
+
+  // Điền tối đa len byte JSON kế tiếp vào buf; trả về 0 khi đã xuất hết
+  size_t read(char *buf, size_t len);
+
+private:
+  struct TaskName {
+    TaskHandle_t handle;
+    char         name[configMAX_TASK_NAME_LEN];
+  };
+
+  bool nextLine();
+
+  TraceEvent *_events;
+  uint16_t    _eventCount;
+  TaskName   *_tasks;
+  uint8_t     _taskCount;
+  uint32_t    _dropped;     // sự kiện đã bị ghi đè trước lúc chụp
+  uint64_t    _nowUs;       // mốc để đổi tsUs 32 bit về thời gian tuyệt đối
+  uint32_t    _nowLow;
+
+  uint8_t     _stage;
+  uint16_t    _index;
+  char        _line[256];
+  uint16_t    _lineLen;
+  uint16_t    _lineOff;
+};
+
+// Begin khi tạo, end khi ra khỏi scope (kể cả return / continue sớm)
+class TraceScope
+{
+public:
+  explicit TraceScope(const char *name) : _name(name) { traceRecord(name, TRACE_PHASE_BEGIN); }
+  ~TraceScope() { traceRecord(_name, TRACE_PHASE_END); }
+
+private:
+  const char *_name;
+};
+
+#define TRACE_CONCAT_(a, b)  a##b
+#define TRACE_CONCAT(a, b)   TRACE_CONCAT_(a, b)
+
+#define TRACE_BEGIN(name)    traceRecord(name, TRACE_PHASE_BEGIN)
+#define TRACE_END(name)      traceRecord(name, TRACE_PHASE_END)
+#define TRACE_INSTANT(name)  traceRecord(name, TRACE_PHASE_INSTANT)
+#define TRACE_SCOPE(name)    TraceScope TRACE_CONCAT(_traceScope, __LINE__)(name)
+
+#else
+
+#define TRACE_BEGIN(name)    ((void)0)
+#define TRACE_END(name)      ((void)0)
+#define TRACE_INSTANT(name)  ((void)0)
+#define TRACE_SCOPE(name)    ((void)0)
+
+#endif
+
+#endif
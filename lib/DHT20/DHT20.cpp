@@ -15,17 +15,47 @@
 const uint8_t DHT20_ADDRESS = 0x38;
 
 
+//  CRC-8, polynomial 0x31 (x8 + x5 + x4 + 1), one lookup per byte
+static const uint8_t DHT20_CRC8_TABLE[256] =
+{
+  0x00, 0x31, 0x62, 0x53, 0xC4, 0xF5, 0xA6, 0x97, 0xB9, 0x88, 0xDB, 0xEA, 0x7D, 0x4C, 0x1F, 0x2E,
+  0x43, 0x72, 0x21, 0x10, 0x87, 0xB6, 0xE5, 0xD4, 0xFA, 0xCB, 0x98, 0xA9, 0x3E, 0x0F, 0x5C, 0x6D,
+  0x86, 0xB7, 0xE4, 0xD5, 0x42, 0x73, 0x20, 0x11, 0x3F, 0x0E, 0x5D, 0x6C, 0xFB, 0xCA, 0x99, 0xA8,
+  0xC5, 0xF4, 0xA7, 0x96, 0x01, 0x30, 0x63, 0x52, 0x7C, 0x4D, 0x1E, 0x2F, 0xB8, 0x89, 0xDA, 0xEB,
+  0x3D, 0x0C, 0x5F, 0x6E, 0xF9, 0xC8, 0x9B, 0xAA, 0x84, 0xB5, 0xE6, 0xD7, 0x40, 0x71, 0x22, 0x13,
+  0x7E, 0x4F, 0x1C, 0x2D, 0xBA, 0x8B, 0xD8, 0xE9, 0xC7, 0xF6, 0xA5, 0x94, 0x03, 0x32, 0x61, 0x50,
+  0xBB, 0x8A, 0xD9, 0xE8, 0x7F, 0x4E, 0x1D, 0x2C, 0x02, 0x33, 0x60, 0x51, 0xC6, 0xF7, 0xA4, 0x95,
+  0xF8, 0xC9, 0x9A, 0xAB, 0x3C, 0x0D, 0x5E, 0x6F, 0x41, 0x70, 0x23, 0x12, 0x85, 0xB4, 0xE7, 0xD6,
+  0x7A, 0x4B, 0x18, 0x29, 0xBE, 0x8F, 0xDC, 0xED, 0xC3, 0xF2, 0xA1, 0x90, 0x07, 0x36, 0x65, 0x54,
+  0x39, 0x08, 0x5B, 0x6A, 0xFD, 0xCC, 0x9F, 0xAE, 0x80, 0xB1, 0xE2, 0xD3, 0x44, 0x75, 0x26, 0x17,
+  0xFC, 0xCD, 0x9E, 0xAF, 0x38, 0x09, 0x5A, 0x6B, 0x45, 0x74, 0x27, 0x16, 0x81, 0xB0, 0xE3, 0xD2,
+  0xBF, 0x8E, 0xDD, 0xEC, 0x7B, 0x4A, 0x19, 0x28, 0x06, 0x37, 0x64, 0x55, 0xC2, 0xF3, 0xA0, 0x91,
+  0x47, 0x76, 0x25, 0x14, 0x83, 0xB2, 0xE1, 0xD0, 0xFE, 0xCF, 0x9C, 0xAD, 0x3A, 0x0B, 0x58, 0x69,
+  0x04, 0x35, 0x66, 0x57, 0xC0, 0xF1, 0xA2, 0x93, 0xBD, 0x8C, 0xDF, 0xEE, 0x79, 0x48, 0x1B, 0x2A,
+  0xC1, 0xF0, 0xA3, 0x92, 0x05, 0x34, 0x67, 0x56, 0x78, 0x49, 0x1A, 0x2B, 0xBC, 0x8D, 0xDE, 0xEF,
+  0x82, 0xB3, 0xE0, 0xD1, 0x46, 0x77, 0x24, 0x15, 0x3B, 0x0A, 0x59, 0x68, 0xFF, 0xCE, 0x9D, 0xAC,
+};
+
+
 DHT20::DHT20(TwoWire *wire)
 {
   _wire        = wire;
   //  reset() ?
-  _temperature = 0;
-  _humidity    = 0;
-  _humOffset   = 0;
-  _tempOffset  = 0;
+  _rawTemperature  = 0x40000;    //  0 C
+  _rawHumidity     = 0;
+  _humOffset       = 0;
+  _tempOffset      = 0;
+  _humOffsetCenti  = 0;
+  _tempOffsetCenti = 0;
   _status      = DHT20_OK;
   _lastRequest = 0;
   _lastRead    = 0;
+
+  _requestMicros  = 0;
+  _triggerMicros  = 0;
+  _collectMicros  = 0;
+  _blockingMicros = 0;
+  _resetCount     = 0;
 }
 
 
@@ -78,6 +108,7 @@ uint8_t DHT20::resetSensor()
     if (_resetRegister(0x1C)) count++;
     if (_resetRegister(0x1E)) count++;
     delay(10);
+    _resetCount++;
   }
   return count;
 }
@@ -90,7 +121,7 @@ uint8_t DHT20::resetSensor()
 int DHT20::read()
 {
   //  do not read to fast == more than once per second.
-  if (millis() - _lastRead < 1000)
+  if (millis() - _lastRead < DHT20_MIN_INTERVAL_MS)
   {
     return DHT20_ERROR_LASTREAD;
   }
@@ -107,14 +138,24 @@ int DHT20::read()
   if (status < 0) return status;
 
   //  convert it to meaningful data
-  return convert();
+  status = convert();
+  _blockingMicros = micros() - _requestMicros;
+  return status;
 }
 
 
 int DHT20::requestData()
 {
+  uint32_t start = micros();
+  _requestMicros = start;
+
   //  reset sensor if needed.
-  resetSensor();
+  //  the status byte of the previous measurement tells whether the
+  //  calibration bits are still set, which saves the status read.
+  if ((_status & 0x18) != 0x18)
+  {
+    resetSensor();
+  }
 
   //  GET CONNECTION
   _wire->beginTransmission(DHT20_ADDRESS);
@@ -124,10 +165,66 @@ int DHT20::requestData()
   int rv = _wire->endTransmission();
 
   _lastRequest = millis();
+  _triggerMicros = micros() - start;
   return rv;
 }
 
 
+////////////////////////////////////////////////
+//
+//  NON-BLOCKING ACQUISITION
+//
+int DHT20::startMeasurement()
+{
+  //  same guard as read()
+  if (millis() - _lastRead < DHT20_MIN_INTERVAL_MS)
+  {
+    return DHT20_ERROR_LASTREAD;
+  }
+  return requestData();
+}
+
+
+bool DHT20::measurementDue()
+{
+  return (millis() - _lastRequest) >= DHT20_MEASURE_TIME_MS;
+}
+
+
+int DHT20::collectMeasurement()
+{
+  //  conversion cannot be done yet, save the bus transaction
+  if (!measurementDue())
+  {
+    return DHT20_ERROR_BUSY;
+  }
+
+  uint32_t start = micros();
+
+  //  the first byte of the measurement is the status byte,
+  //  so no separate readStatus() is needed to poll for completion.
+  int status = readData();
+  if (status >= 0)
+  {
+    if (_bits[0] & 0x80)
+    {
+      status = DHT20_ERROR_BUSY;
+    }
+    else
+    {
+      status = convert();
+    }
+  }
+
+  _collectMicros = micros() - start;
+  if (status == DHT20_OK)
+  {
+    _blockingMicros = micros() - _requestMicros;
+  }
+  return status;
+}
+
+
 int DHT20::readData()
 {
   //  GET DATA
@@ -163,14 +260,14 @@ int DHT20::convert()
   raw += _bits[2];
   raw <<= 4;
   raw += (_bits[3] >> 4);
-  _humidity = raw * 9.5367431640625e-5;   // ==> / 1048576.0 * 100%;
+  _rawHumidity = raw;
 
   raw = (_bits[3] & 0x0F);
   raw <<= 8;
   raw += _bits[4];
   raw <<= 8;
   raw += _bits[5];
-  _temperature = raw * 1.9073486328125e-4 - 50;  //  ==> / 1048576.0 * 200 - 50;
+  _rawTemperature = raw;
 
   //  TEST CHECKSUM
   uint8_t _crc = _crc8(_bits, 6);
@@ -187,27 +284,56 @@ int DHT20::convert()
 //
 //  TEMPERATURE & HUMIDITY & OFFSET
 //
+//  single precision constants: the ESP32 FPU has no double support
 float DHT20::getHumidity()
 {
-  return _humidity + _humOffset;
+  return _rawHumidity * 9.5367431640625e-5f + _humOffset;        //  ==> / 1048576.0 * 100%;
 };
 
 
 float DHT20::getTemperature()
 {
-  return _temperature + _tempOffset;
+  return _rawTemperature * 1.9073486328125e-4f - 50 + _tempOffset;  //  ==> / 1048576.0 * 200 - 50;
+};
+
+
+uint32_t DHT20::getRawHumidity()
+{
+  return _rawHumidity;
+};
+
+
+uint32_t DHT20::getRawTemperature()
+{
+  return _rawTemperature;
+};
+
+
+//  raw * 10000 / 2^20 == raw * 625 / 2^16, fits in 32 bit for 20-bit raw
+int16_t DHT20::getHumidityCenti()
+{
+  return (int16_t)(((_rawHumidity * 625UL + 0x8000UL) >> 16) + _humOffsetCenti);
+};
+
+
+//  raw * 20000 / 2^20 - 5000 == raw * 1250 / 2^16 - 5000
+int16_t DHT20::getTemperatureCenti()
+{
+  return (int16_t)((int32_t)((_rawTemperature * 1250UL + 0x8000UL) >> 16) - 5000 + _tempOffsetCenti);
 };
 
 
 void DHT20::setHumOffset(float offset)
 {
   _humOffset = offset;
+  _humOffsetCenti = (int16_t)lroundf(offset * 100);
 };
 
 
 void DHT20::setTempOffset(float offset)
 {
   _tempOffset = offset;
+  _tempOffsetCenti = (int16_t)lroundf(offset * 100);
 };
 
 
@@ -275,6 +401,30 @@ uint32_t DHT20::lastRequest()
 };
 
 
+uint32_t DHT20::triggerMicros()
+{
+  return _triggerMicros;
+};
+
+
+uint32_t DHT20::collectMicros()
+{
+  return _collectMicros;
+};
+
+
+uint32_t DHT20::blockingMicros()
+{
+  return _blockingMicros;
+};
+
+
+uint32_t DHT20::resetCount()
+{
+  return _resetCount;
+};
+
+
 ////////////////////////////////////////////////
 //
 //  PRIVATE
@@ -284,19 +434,7 @@ uint8_t DHT20::_crc8(uint8_t *ptr, uint8_t len)
   uint8_t crc = 0xFF;
   while(len--)
   {
-    crc ^= *ptr++;
-    for (uint8_t i = 0; i < 8; i++)
-    {
-      if (crc & 0x80)
-      {
-        crc <<= 1;
-        crc ^= 0x31;
-      }
-      else
-      {
-        crc <<= 1;
-      }
-    }
+    crc = DHT20_CRC8_TABLE[crc ^ *ptr++];
   }
   return crc;
 }
@@ -29,6 +29,13 @@
 #define DHT20_ERROR_BYTES_ALL_ZERO          -13
 #define DHT20_ERROR_READ_TIMEOUT            -14
 #define DHT20_ERROR_LASTREAD                -15
+#define DHT20_ERROR_BUSY                    -16
+
+//  typical conversion time after a trigger, datasheet 7.4 point 3
+#define DHT20_MEASURE_TIME_MS                80
+//  minimum time between two measurements, as read() enforces it
+//  (faster sampling heats the sensor and skews the readings)
+#define DHT20_MIN_INTERVAL_MS                1000
 
 
 class DHT20
@@ -56,13 +63,35 @@ public:
   int      convert();
 
 
+  //  NON-BLOCKING ACQUISITION
+  //  trigger a measurement without waiting for it.
+  //  the register reset is skipped when the last status byte was healthy.
+  //  returns DHT20_ERROR_LASTREAD within DHT20_MIN_INTERVAL_MS of the last read.
+  int      startMeasurement();
+  //  true once DHT20_MEASURE_TIME_MS has elapsed since startMeasurement().
+  bool     measurementDue();
+  //  read + convert the pending measurement.
+  //  returns DHT20_ERROR_BUSY, without touching the bus, before measurementDue(),
+  //  and DHT20_ERROR_BUSY when the sensor is still converting.
+  int      collectMeasurement();
+
+
   //  SYNCHRONOUS CALL
   //  blocking read call to read + convert data
   int      read();
   //  access the converted temperature & humidity
+  //  (float conversion happens here, not in convert())
   float    getHumidity();
   float    getTemperature();
 
+  //  FIXED POINT ACCESS  (no float / double math)
+  //  raw 20-bit sensor counts of the last conversion
+  uint32_t getRawHumidity();
+  uint32_t getRawTemperature();
+  //  humidity in 0.01 %RH, temperature in 0.01 C, rounded, offsets included
+  int16_t  getHumidityCenti();
+  int16_t  getTemperatureCenti();
+
 
   //  OFFSET  1st order adjustments
   void     setHumOffset(float offset = 0);
@@ -86,6 +115,15 @@ public:
   uint32_t lastRequest();
 
 
+  //  LATENCY COUNTERS  (microseconds spent on the bus / in the call)
+  uint32_t triggerMicros();    //  last startMeasurement() / requestData()
+  uint32_t collectMicros();    //  last collectMeasurement()
+  //  last request -> converted data, i.e. how long a blocking read() holds
+  //  the caller; set by read() and by a successful collectMeasurement()
+  uint32_t blockingMicros();
+  uint32_t resetCount();       //  number of resetSensor() calls that reset
+
+
   //  RESET  (new since 0.1.4)
   //  use with care
   //  returns number of registers reset => must be 3
@@ -98,16 +136,24 @@ public:
 
 
 private:
-  float    _humidity;
-  float    _temperature;
+  uint32_t _rawHumidity;
+  uint32_t _rawTemperature;
   float    _humOffset;
   float    _tempOffset;
+  int16_t  _humOffsetCenti;
+  int16_t  _tempOffsetCenti;
 
   uint8_t  _status;
   uint32_t _lastRequest;
   uint32_t _lastRead;
   uint8_t  _bits[7];
 
+  uint32_t _requestMicros;
+  uint32_t _triggerMicros;
+  uint32_t _collectMicros;
+  uint32_t _blockingMicros;
+  uint32_t _resetCount;
+
   uint8_t  _crc8(uint8_t *ptr, uint8_t len);
 
   //  use with care
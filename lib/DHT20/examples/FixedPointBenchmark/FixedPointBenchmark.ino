@@ -0,0 +1,153 @@
+//
+//    FILE: FixedPointBenchmark.ino
+// PURPOSE: compare the float and fixed point DHT20 conversion paths
+//
+//  No sensor needed: a set of synthetic 7-byte frames is pushed through
+//  - the original path: bitwise CRC, double constants, printf("%.2f")
+//  - the fixed path:    table CRC, integer centi conversion, integer formatting
+//  and the average time per frame is printed for both.
+
+
+#include "Arduino.h"
+
+const int FRAMES = 64;
+const int ROUNDS = 200;
+
+uint8_t frames[FRAMES][7];
+uint8_t crcTable[256];
+volatile int32_t sink;
+
+
+uint8_t crcBitwise(const uint8_t *ptr, uint8_t len)
+{
+  uint8_t crc = 0xFF;
+  while (len--)
+  {
+    crc ^= *ptr++;
+    for (uint8_t i = 0; i < 8; i++)
+    {
+      crc = (crc & 0x80) ? (crc << 1) ^ 0x31 : crc << 1;
+    }
+  }
+  return crc;
+}
+
+
+uint8_t crcTableDriven(const uint8_t *ptr, uint8_t len)
+{
+  uint8_t crc = 0xFF;
+  while (len--) crc = crcTable[crc ^ *ptr++];
+  return crc;
+}
+
+
+//  "-12.34", no printf
+int formatCenti(char *buf, int32_t v)
+{
+  char tmp[12];
+  int n = 0;
+  bool neg = v < 0;
+  uint32_t mag = neg ? -v : v;
+  tmp[n++] = '0' + mag % 10;  mag /= 10;
+  tmp[n++] = '0' + mag % 10;  mag /= 10;
+  tmp[n++] = '.';
+  do { tmp[n++] = '0' + mag % 10; mag /= 10; } while (mag);
+  if (neg) tmp[n++] = '-';
+  int out = 0;
+  while (n) buf[out++] = tmp[--n];
+  buf[out] = 0;
+  return out;
+}
+
+
+uint32_t runFloat()
+{
+  char text[16];
+  uint32_t start = micros();
+  for (int r = 0; r < ROUNDS; r++)
+  {
+    for (int f = 0; f < FRAMES; f++)
+    {
+      const uint8_t *b = frames[f];
+      if (crcBitwise(b, 6) != b[6]) continue;
+      uint32_t rh = ((uint32_t)b[1] << 12) | ((uint32_t)b[2] << 4) | (b[3] >> 4);
+      uint32_t rt = ((uint32_t)(b[3] & 0x0F) << 16) | ((uint32_t)b[4] << 8) | b[5];
+      float humidity    = rh * 9.5367431640625e-5;
+      float temperature = rt * 1.9073486328125e-4 - 50;
+      int level = (temperature < 24.0f) ? 0 : (temperature > 32.0f) ? 2 : 1;
+      level += (humidity < 30.0f) ? 0 : (humidity > 80.0f) ? 6 : 3;
+      sink = level + snprintf(text, sizeof(text), "%.2f", temperature)
+                   + snprintf(text, sizeof(text), "%.2f", humidity);
+    }
+  }
+  return micros() - start;
+}
+
+
+uint32_t runFixed()
+{
+  char text[16];
+  uint32_t start = micros();
+  for (int r = 0; r < ROUNDS; r++)
+  {
+    for (int f = 0; f < FRAMES; f++)
+    {
+      const uint8_t *b = frames[f];
+      if (crcTableDriven(b, 6) != b[6]) continue;
+      uint32_t rh = ((uint32_t)b[1] << 12) | ((uint32_t)b[2] << 4) | (b[3] >> 4);
+      uint32_t rt = ((uint32_t)(b[3] & 0x0F) << 16) | ((uint32_t)b[4] << 8) | b[5];
+      int32_t humidity    = (rh * 625UL + 0x8000UL) >> 16;
+      int32_t temperature = (int32_t)((rt * 1250UL + 0x8000UL) >> 16) - 5000;
+      int level = (temperature < 2400) ? 0 : (temperature > 3200) ? 2 : 1;
+      level += (humidity < 3000) ? 0 : (humidity > 8000) ? 6 : 3;
+      sink = level + formatCenti(text, temperature) + formatCenti(text, humidity);
+    }
+  }
+  return micros() - start;
+}
+
+
+void setup()
+{
+  Serial.begin(115200);
+  Serial.println(__FILE__);
+
+  for (int i = 0; i < 256; i++)
+  {
+    uint8_t c = i;
+    for (int k = 0; k < 8; k++) c = (c & 0x80) ? (c << 1) ^ 0x31 : c << 1;
+    crcTable[i] = c;
+  }
+
+  //  frames spread over the sensor range, valid CRC
+  for (int f = 0; f < FRAMES; f++)
+  {
+    uint32_t rh = (uint32_t)f * 16411;
+    uint32_t rt = 0x40000 + (uint32_t)f * 5003;
+    frames[f][0] = 0x1C;
+    frames[f][1] = rh >> 12;
+    frames[f][2] = rh >> 4;
+    frames[f][3] = ((rh & 0x0F) << 4) | ((rt >> 16) & 0x0F);
+    frames[f][4] = rt >> 8;
+    frames[f][5] = rt;
+    frames[f][6] = crcBitwise(frames[f], 6);
+  }
+
+  uint32_t tFloat = runFloat();
+  uint32_t tFixed = runFixed();
+
+  Serial.print("float path: ");
+  Serial.print((float)tFloat / (ROUNDS * FRAMES), 3);
+  Serial.println(" us/frame");
+  Serial.print("fixed path: ");
+  Serial.print((float)tFixed / (ROUNDS * FRAMES), 3);
+  Serial.println(" us/frame");
+}
+
+
+void loop()
+{
+}
+
+
+//  -- END OF FILE --
@@ -0,0 +1,80 @@
+#include "LcdFrameBuffer.h"
+#include <string.h>
+
+// Two changed runs separated by this many unchanged cells are sent as one run:
+// rewriting one unchanged cell costs the same single byte as a setCursor command.
+#define LCD_FB_MERGE_GAP 1
+
+LcdFrameBuffer::LcdFrameBuffer(LiquidCrystal_I2C &lcd) : _lcd(lcd)
+{
+	clear();
+	_glassValid = false;
+	_lastBytes = 0;
+	_totalBytes = 0;
+	_frames = 0;
+}
+
+void LcdFrameBuffer::clear() {
+	memset(_next, ' ', sizeof(_next));
+}
+
+void LcdFrameBuffer::setLine(uint8_t row, const char *text) {
+	if (row >= LCD_FB_ROWS) {
+		return;
+	}
+	memset(_next[row], ' ', LCD_FB_COLS);
+	print(0, row, text);
+}
+
+void LcdFrameBuffer::print(uint8_t col, uint8_t row, const char *text) {
+	if (row >= LCD_FB_ROWS || text == NULL) {
+		return;
+	}
+	while (col < LCD_FB_COLS && *text) {
+		_next[row][col++] = *text++;
+	}
+}
+
+void LcdFrameBuffer::invalidate() {
+	_glassValid = false;
+}
+
+size_t LcdFrameBuffer::flush() {
+	size_t bytes = 0;
+
+	for (uint8_t row = 0; row < LCD_FB_ROWS; row++) {
+		uint8_t col = 0;
+		while (col < LCD_FB_COLS) {
+			// skip cells that already show the right character
+			if (_glassValid && _next[row][col] == _glass[row][col]) {
+				col++;
+				continue;
+			}
+
+			// extend the run while cells differ or the gap is cheaper than a new setCursor
+			uint8_t start = col;
+			uint8_t end = col + 1;
+			uint8_t scan = end;
+			while (scan < LCD_FB_COLS) {
+				if (!_glassValid || _next[row][scan] != _glass[row][scan]) {
+					end = scan + 1;
+				} else if (scan - end >= LCD_FB_MERGE_GAP) {
+					break;
+				}
+				scan++;
+			}
+
+			_lcd.setCursor(start, row);
+			_lcd.write((const uint8_t *)&_next[row][start], end - start);
+			memcpy(&_glass[row][start], &_next[row][start], end - start);
+			bytes += 1 + (end - start);
+			col = end;
+		}
+	}
+
+	_glassValid = true;
+	_lastBytes = bytes;
+	_totalBytes += bytes;
+	_frames++;
+	return bytes;
+}
@@ -0,0 +1,68 @@
+#ifndef FDB_LCD_FRAME_BUFFER_H
+#define FDB_LCD_FRAME_BUFFER_H
+
+#include <inttypes.h>
+#include <stddef.h>
+#include "LiquidCrystal_I2C.h"
+
+#define LCD_FB_COLS 16
+#define LCD_FB_ROWS 2
+
+/**
+ * Shadow framebuffer for a 16x2 LiquidCrystal_I2C display.
+ *
+ * Text is composed into an off-screen frame; flush() compares it with what is
+ * currently on the glass and only sends setCursor() plus the runs of cells that
+ * changed. A stable frame therefore costs no I2C traffic at all, and clear() with
+ * its 2 ms busy wait is never needed.
+ */
+class LcdFrameBuffer {
+public:
+	/**
+	 * @param lcd	Display to render to, begin() must have been called on it.
+	 */
+	LcdFrameBuffer(LiquidCrystal_I2C &lcd);
+
+	/**
+	 * Fill the next frame with spaces.
+	 */
+	void clear();
+
+	/**
+	 * Replace a whole row of the next frame, padding with spaces.
+	 */
+	void setLine(uint8_t row, const char *text);
+
+	/**
+	 * Write text into the next frame starting at col/row, clipped at the row end.
+	 */
+	void print(uint8_t col, uint8_t row, const char *text);
+
+	/**
+	 * Send the differences between the next frame and the glass.
+	 *
+	 * @return Number of HD44780 bytes (commands + characters) sent for this frame.
+	 */
+	size_t flush();
+
+	/**
+	 * Forget what is on the glass, the next flush() redraws every cell.
+	 * Call after anything else wrote to the display (begin(), clear(), print()).
+	 */
+	void invalidate();
+
+	size_t lastFlushBytes() const { return _lastBytes; }
+	uint32_t totalBytes() const { return _totalBytes; }
+	uint32_t frames() const { return _frames; }
+
+private:
+	LiquidCrystal_I2C &_lcd;
+	char _next[LCD_FB_ROWS][LCD_FB_COLS];
+	char _glass[LCD_FB_ROWS][LCD_FB_COLS];
+	bool _glassValid;
+	size_t _lastBytes;
+	uint32_t _totalBytes;
+	uint32_t _frames;
+};
+
+#endif // FDB_LCD_FRAME_BUFFER_H
@@ -3,6 +3,16 @@
 #include <Arduino.h>
 #include <Wire.h>
 
+// Bytes per character in batch mode: (data, data|En, data) for each nibble
+#define LCD_BYTES_PER_CHAR 6
+
+// Largest transmission the Wire TX buffer accepts
+#ifdef I2C_BUFFER_LENGTH
+#define LCD_I2C_BATCH_BYTES I2C_BUFFER_LENGTH
+#else
+#define LCD_I2C_BATCH_BYTES 32
+#endif
+
 // When the display powers up, it is configured as follows:
 //
 // 1. Display clear
@@ -29,6 +39,8 @@ LiquidCrystal_I2C::LiquidCrystal_I2C(uint8_t lcd_addr, uint8_t lcd_cols, uint8_t
 	_rows = lcd_rows;
 	_charsize = charsize;
 	_backlightval = LCD_BACKLIGHT;
+	_batch = false;
+	_transmissions = 0;
 }
 
 void LiquidCrystal_I2C::begin() {
@@ -208,17 +220,71 @@ inline size_t LiquidCrystal_I2C::write(uint8_t value) {
 	return 1;
 }
 
+size_t LiquidCrystal_I2C::write(const uint8_t *buffer, size_t size) {
+	if (!_batch) {
+		return Print::write(buffer, size);
+	}
+
+	uint8_t packet[LCD_I2C_BATCH_BYTES];
+	size_t done = 0;
+	while (done < size) {
+		size_t len = 0;
+		while (done < size && len + LCD_BYTES_PER_CHAR <= sizeof(packet)) {
+			len += packByte(&packet[len], buffer[done++], Rs);
+		}
+		Wire.beginTransmission(_addr);
+		Wire.write(packet, len);
+		Wire.endTransmission();
+		_transmissions++;
+	}
+	return size;
+}
+
+void LiquidCrystal_I2C::setBatchMode(bool enabled) {
+	_batch = enabled;
+}
+
+bool LiquidCrystal_I2C::getBatchMode() {
+	return _batch;
+}
+
+uint32_t LiquidCrystal_I2C::transmissions() {
+	return _transmissions;
+}
+
 
 /************ low level data pushing commands **********/
 
 // write either command or data
 void LiquidCrystal_I2C::send(uint8_t value, uint8_t mode) {
+	if (_batch) {
+		uint8_t packet[LCD_BYTES_PER_CHAR];
+		size_t len = packByte(packet, value, mode);
+		Wire.beginTransmission(_addr);
+		Wire.write(packet, len);
+		Wire.endTransmission();
+		_transmissions++;
+		return;
+	}
+
 	uint8_t highnib=value&0xf0;
 	uint8_t lownib=(value<<4)&0xf0;
 	write4bits((highnib)|mode);
 	write4bits((lownib)|mode);
 }
 
+// same expander states as write4bits() for both nibbles, back to back
+size_t LiquidCrystal_I2C::packByte(uint8_t *out, uint8_t value, uint8_t mode) {
+	uint8_t nibbles[2] = { (uint8_t)((value & 0xf0) | mode), (uint8_t)(((value << 4) & 0xf0) | mode) };
+	size_t len = 0;
+	for (int i = 0; i < 2; i++) {
+		out[len++] = nibbles[i] | _backlightval;
+		out[len++] = (nibbles[i] | En) | _backlightval;	// En high
+		out[len++] = (nibbles[i] & ~En) | _backlightval;	// En low
+	}
+	return len;
+}
+
 void LiquidCrystal_I2C::write4bits(uint8_t value) {
 	expanderWrite(value);
 	pulseEnable(value);
@@ -228,6 +294,7 @@ void LiquidCrystal_I2C::expanderWrite(uint8_t _data){
 	Wire.beginTransmission(_addr);
 	Wire.write((int)(_data) | _backlightval);
 	Wire.endTransmission();
+	_transmissions++;
 }
 
 void LiquidCrystal_I2C::pulseEnable(uint8_t _data){
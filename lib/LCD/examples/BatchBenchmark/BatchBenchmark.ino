@@ -0,0 +1,55 @@
+// Compares the per-nibble I2C path of LiquidCrystal_I2C with batch mode.
+//
+// Writes the same 16-character line a number of times in each mode and prints
+// the average time per line and the number of I2C transmissions it took.
+// Expected: ~96 transmissions per line unbatched, 1 per line batched.
+
+#include <Wire.h>
+#include <LiquidCrystal_I2C.h>
+
+// Pins and address of the YOLO UNO board used by the main firmware
+#define SDA_PIN 11
+#define SCL_PIN 12
+#define LCD_ADDR 33
+
+const char kLine[] = "T:25.1C H:60%   ";
+const int kRounds = 50;
+
+LiquidCrystal_I2C lcd(LCD_ADDR, 16, 2);
+
+void runBenchmark(bool batch, uint32_t clockHz) {
+  Wire.setClock(clockHz);
+  lcd.setBatchMode(batch);
+
+  uint32_t tx0 = lcd.transmissions();
+  uint32_t t0 = micros();
+  for (int i = 0; i < kRounds; i++) {
+    lcd.setCursor(0, 1);
+    lcd.write((const uint8_t *)kLine, sizeof(kLine) - 1);
+  }
+  uint32_t elapsed = micros() - t0;
+  uint32_t tx = lcd.transmissions() - tx0;
+
+  Serial.print(batch ? "batched   " : "unbatched ");
+  Serial.print(clockHz / 1000);
+  Serial.print(" kHz: ");
+  Serial.print(elapsed / kRounds);
+  Serial.print(" us/line, ");
+  Serial.print(tx / kRounds);
+  Serial.println(" transmissions/line (incl. setCursor)");
+}
+
+void setup() {
+  Serial.begin(115200);
+  Wire.begin(SDA_PIN, SCL_PIN);
+  lcd.begin();
+  lcd.backlight();
+  lcd.setCursor(0, 0);
+  lcd.print("LCD benchmark");
+
+  runBenchmark(false, 100000);
+  runBenchmark(true, 100000);
+}
+
+void loop() {
+}
@@ -0,0 +1,176 @@
+#include "adaptive_sampler.h"
+
+AdaptiveSampler adaptiveSampler;
+
+static const char *const samplerReasonNames[SAMPLER_REASON_COUNT] = {
+  "stable", "near", "slope", "anomaly", "error"
+};
+
+const char *samplerReasonName(uint8_t reason)
+{
+  return reason < SAMPLER_REASON_COUNT ? samplerReasonNames[reason] : "?";
+}
+
+AdaptiveSampler::AdaptiveSampler()
+  : _hasLast(false), _lastMs(0), _lastTemp(0.0f), _lastHumi(0.0f)
+{
+  _mux = portMUX_INITIALIZER_UNLOCKED;
+
+  _cfg.enabled       = true;
+  _cfg.min_period_ms = 2000;
+  _cfg.max_period_ms = 30000;
+  _cfg.temp_margin   = 1.0f;
+  _cfg.humi_margin   = 5.0f;
+  _cfg.temp_slope    = 0.5f;
+  _cfg.humi_slope    = 3.0f;
+  _cfg.growth        = 1.5f;
+
+  _period = _cfg.min_period_ms;
+  memset(&_stats, 0, sizeof(_stats));
+  _stats.period_ms = _cfg.min_period_ms;
+}
+
+// Khoảng cách tới biên gần nhất của dải [low, high]; âm nếu đã ra ngoài dải
+float AdaptiveSampler::distanceToBand(float value, float low, float high)
+{
+  float dLow  = value - low;
+  float dHigh = high - value;
+  return dLow < dHigh ? dLow : dHigh;
+}
+
+uint32_t AdaptiveSampler::next(uint32_t nowMs, bool valid, float temperature, float humidity,
+                               bool anomaly, const RuntimeConfig &rc)
+{
+  SamplerConfig cfg;
+  portENTER_CRITICAL(&_mux);
+  cfg = _cfg;
+  portEXIT_CRITICAL(&_mux);
+
+  uint8_t reason = SAMPLER_REASON_STABLE;
+
+  if (!valid)
+  {
+    reason = SAMPLER_REASON_ERROR;
+  }
+  else
+  {
+    // Ngoài dải bình thường cũng tính là "gần" (distance âm)
+    float tDist = distanceToBand(temperature, rc.tempCold, rc.tempHot);
+    float hDist = distanceToBand(humidity, rc.humiDry, rc.humiHumid);
+
+    float tSlope = 0.0f;
+    float hSlope = 0.0f;
+    if (_hasLast && nowMs != _lastMs)
+    {
+      float minutes = (nowMs - _lastMs) / 60000.0f;
+      tSlope = fabsf(temperature - _lastTemp) / minutes;
+      hSlope = fabsf(humidity - _lastHumi) / minutes;
+    }
+
+    if (anomaly)
+      reason = SAMPLER_REASON_ANOMALY;
+    else if (tDist < cfg.temp_margin || hDist < cfg.humi_margin)
+      reason = SAMPLER_REASON_NEAR;
+    else if (tSlope > cfg.temp_slope || hSlope > cfg.humi_slope)
+      reason = SAMPLER_REASON_SLOPE;
+
+    _hasLast  = true;
+    _lastMs   = nowMs;
+    _lastTemp = temperature;
+    _lastHumi = humidity;
+  }
+
+  // Có sự kiện → về chu kỳ nhanh ngay; ổn định → giãn dần tới max
+  if (!cfg.enabled || reason != SAMPLER_REASON_STABLE)
+    _period = cfg.min_period_ms;
+  else
+    _period *= cfg.growth;
+
+  if (_period < cfg.min_period_ms) _period = cfg.min_period_ms;
+  if (_period > cfg.max_period_ms) _period = cfg.max_period_ms;
+
+  uint32_t period = (uint32_t)_period;
+
+  portENTER_CRITICAL(&_mux);
+  if (_stats.samples == 0)
+    _stats.since_ms = nowMs;
+  _stats.samples++;
+  _stats.reasons[reason]++;
+  _stats.reason    = reason;
+  _stats.period_ms = period;
+  portEXIT_CRITICAL(&_mux);
+
+  return period;
+}
+
+void AdaptiveSampler::setConfig(const SamplerConfig &cfg)
+{
+  SamplerConfig c = cfg;
+  if (c.min_period_ms < SAMPLER_PERIOD_FLOOR_MS) c.min_period_ms = SAMPLER_PERIOD_FLOOR_MS;
+  if (c.max_period_ms > SAMPLER_PERIOD_CEIL_MS)  c.max_period_ms = SAMPLER_PERIOD_CEIL_MS;
+  if (c.max_period_ms < c.min_period_ms)         c.max_period_ms = c.min_period_ms;
+  if (!(c.growth > 1.0f)) c.growth = 1.0f;
+  if (c.growth > 4.0f)    c.growth = 4.0f;
+  if (!(c.temp_margin >= 0.0f)) c.temp_margin = 0.0f;
+  if (!(c.humi_margin >= 0.0f)) c.humi_margin = 0.0f;
+  if (!(c.temp_slope > 0.0f))   c.temp_slope = 0.1f;
+  if (!(c.humi_slope > 0.0f))   c.humi_slope = 0.1f;
+
+  portENTER_CRITICAL(&_mux);
+  _cfg = c;
+  portEXIT_CRITICAL(&_mux);
+}
+
+void AdaptiveSampler::getConfig(SamplerConfig &out)
+{
+  portENTER_CRITICAL(&_mux);
+  out = _cfg;
+  portEXIT_CRITICAL(&_mux);
+}
+
+void AdaptiveSampler::getStats(SamplerStats &out)
+{
+  portENTER_CRITICAL(&_mux);
+  out = _stats;
+  portEXIT_CRITICAL(&_mux);
+}
+
+void AdaptiveSampler::resetStats()
+{
+  portENTER_CRITICAL(&_mux);
+  uint32_t period = _stats.period_ms;
+  memset(&_stats, 0, sizeof(_stats));
+  _stats.period_ms = period;
+  portEXIT_CRITICAL(&_mux);
+}
+
+void AdaptiveSampler::toJson(JsonObject out)
+{
+  SamplerConfig cfg;
+  SamplerStats  st;
+  getConfig(cfg);
+  getStats(st);
+
+  out["enabled"]    = cfg.enabled;
+  out["minPeriod"]  = cfg.min_period_ms;
+  out["maxPeriod"]  = cfg.max_period_ms;
+  out["tempMargin"] = cfg.temp_margin;
+  out["humiMargin"] = cfg.humi_margin;
+  out["tempSlope"]  = cfg.temp_slope;
+  out["humiSlope"]  = cfg.humi_slope;
+  out["growth"]     = cfg.growth;
+
+  out["period"]  = st.period_ms;
+  out["reason"]  = samplerReasonName(st.reason);
+  out["samples"] = st.samples;
+
+  // Tần số hiệu dụng: số mẫu / phút kể từ lúc bắt đầu thống kê
+  uint32_t elapsed = millis() - st.since_ms;
+  out["perMinute"] = (st.samples > 1 && elapsed > 0)
+                       ? (st.samples - 1) * 60000.0f / elapsed
+                       : 0.0f;
+
+  JsonObject reasons = out.createNestedObject("reasons");
+  for (uint8_t i = 0; i < SAMPLER_REASON_COUNT; ++i)
+    reasons[samplerReasonNames[i]] = st.reasons[i];
+}
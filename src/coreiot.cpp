@@ -1,6 +1,15 @@
 #include "coreiot.h"
+#include "event_bus.h"
+#include "telemetry_encoder.h"
+#include "runtime_config.h"
+#include "metrics.h"
+#include "trace.h"
+#include "latency.h"
+#include "logger.h"
+#include "heap_stats.h"
 #include <ctype.h>
 #include <string.h>  
+#include <lwip/sockets.h>
 
 WiFiClient   espClient;
 PubSubClient client(espClient);
@@ -47,9 +56,10 @@ static const char* extractRequestId(const char *topic)
 // Publish response RPC
 static void sendRpcResponse(const char *requestId, const StaticJsonDocument<128> &doc)
 {
+  HEAP_TAG("mqtt_rpc_resp");
   if (!requestId)
   {
-    Serial.println("[CoreIoT] (no requestId) Skip RPC response");
+    LOGW(MQTT, "(no requestId) Skip RPC response");
     return;
   }
 
@@ -61,21 +71,65 @@ static void sendRpcResponse(const char *requestId, const StaticJsonDocument<128>
   serializeJson(doc, payload);
 
   bool ok = client.publish(respTopic, payload.c_str());
-  Serial.print("[CoreIoT] RPC response -> ");
-  Serial.println(ok ? "OK" : "FAILED");
+  LOGI(MQTT, "RPC response -> %s", ok ? "OK" : "FAILED");
 }
 
 static void publishLedStates()
 {
+  HEAP_TAG("mqtt_attr");
+  RuntimeConfig cfg;
+  runtimeConfigRead(cfg);
+
   StaticJsonDocument<128> doc;
-  doc["tempLed"] = glob_temp_led_enabled;
-  doc["humiLed"] = glob_humi_led_enabled;
+  doc["tempLed"] = cfg.tempLedEnabled;
+  doc["humiLed"] = cfg.humiLedEnabled;
 
   String json;
   serializeJson(doc, json);
   client.publish("v1/devices/me/attributes", json.c_str());
 }
 
+// Ghi thẳng frame vào gói MQTT, envelope chỉ là cặp ngoặc nhọn
+static void publishTelemetry(const TelemetryFrame &frame)
+{
+  TRACE_SCOPE("mqtt_publish");
+  if (!client.beginPublish("v1/devices/me/telemetry", frame.len + 2, false))
+  {
+    metricInc(METRIC_MQTT_FAILURES);
+    return;
+  }
+  client.write('{');
+  client.write((const uint8_t *)frame.body, frame.len);
+  client.write('}');
+  if (!client.endPublish())
+  {
+    metricInc(METRIC_MQTT_FAILURES);
+    return;
+  }
+  metricInc(METRIC_MQTT_PUBLISHES);
+  // Gồm cả thời gian frame chờ lượt gửi (TELEMETRY_INTERVAL)
+  latencyRecord(LATENCY_SINK_MQTT, frame.acquired_us);
+}
+
+// Tóm tắt metrics lên attributes: heap, tải core, bộ đếm subsystem
+static void publishMetrics()
+{
+  TRACE_SCOPE("mqtt_metrics");
+  StaticJsonDocument<1024> doc;
+  metricsSummaryToJson(doc.to<JsonObject>());
+
+  char payload[896];
+  size_t len = serializeJson(doc, payload, sizeof(payload));
+  if (len == 0 || len >= sizeof(payload) - 1 ||
+      !client.beginPublish("v1/devices/me/attributes", len, false))
+  {
+    metricInc(METRIC_MQTT_FAILURES);
+    return;
+  }
+  client.write((const uint8_t *)payload, len);
+  metricInc(client.endPublish() ? METRIC_MQTT_PUBLISHES : METRIC_MQTT_FAILURES);
+}
+
 void callback(char* topic, byte* payload, unsigned int length)
 {
   // Lấy requestId từ topic
@@ -87,12 +141,14 @@ void callback(char* topic, byte* payload, unsigned int length)
   memcpy(message, payload, length);
   message[length] = '\0';
 
-  Serial.printf("[CoreIoT] RPC Recv: %s\n", message);
+  HEAP_TAG("mqtt_rpc");
+  LOGI(MQTT, "RPC Recv: %s", message);
+  metricInc(METRIC_MQTT_RPC);
 
   StaticJsonDocument<256> doc;
   DeserializationError error = deserializeJson(doc, message);
   if (error) {
-    Serial.println("JSON Error");
+    LOGW(MQTT, "RPC JSON Error: %s", error.c_str());
     return;
   }
 
@@ -105,59 +161,68 @@ void callback(char* topic, byte* payload, unsigned int length)
   if (strcmp(method, "setTempLed") == 0)
   {
     bool newState = rpcParamToBool(params);
-    glob_temp_led_enabled = newState;
-    
+    runtimeConfigEdit().tempLedEnabled = newState;
+    runtimeConfigCommit();
+
+    ConfigChangeEvent ev = {CONFIG_DEVICE_ENABLE};
+    eventPublish(TOPIC_CONFIG_CHANGE, ev);
+
     // Gửi response NGAY LẬP TỨC
     publishLedStates();
     StaticJsonDocument<128> resp;
     resp["method"]  = "setTempLed";
     resp["success"] = true;
-    resp["tempLed"] = glob_temp_led_enabled;
+    resp["tempLed"] = newState;
     sendRpcResponse(requestId, resp);
   }
   // ----- RPC SET: Bật/tắt NeoPixel -----
   else if (strcmp(method, "setHumiLed") == 0)
   {
     bool newState = rpcParamToBool(params);
-    glob_humi_led_enabled = newState;
+    runtimeConfigEdit().humiLedEnabled = newState;
+    runtimeConfigCommit();
     
-    // Kích hoạt semaphore ngay để task LED phản hồi
-    if (xHumiNeoSemaphore != nullptr)
-      xSemaphoreGive(xHumiNeoSemaphore);
+    // Báo qua event bus để task NeoPixel phản hồi ngay
+    ConfigChangeEvent ev = {CONFIG_DEVICE_ENABLE};
+    eventPublish(TOPIC_CONFIG_CHANGE, ev);
 
     publishLedStates();
     StaticJsonDocument<128> resp;
     resp["method"]  = "setHumiLed";
     resp["success"] = true;
-    resp["humiLed"] = glob_humi_led_enabled;
+    resp["humiLed"] = newState;
     sendRpcResponse(requestId, resp);
   }
   // ----- RPC GET -----
   else if (strcmp(method, "getTempLed") == 0)
   {
     StaticJsonDocument<128> resp;
+    RuntimeConfig cfg;
+    runtimeConfigRead(cfg);
     resp["method"]  = "getTempLed";
-    resp["tempLed"] = glob_temp_led_enabled;
+    resp["tempLed"] = cfg.tempLedEnabled;
     sendRpcResponse(requestId, resp);
   }
   else if (strcmp(method, "getHumiLed") == 0)
   {
     StaticJsonDocument<128> resp;
+    RuntimeConfig cfg;
+    runtimeConfigRead(cfg);
     resp["method"]  = "getHumiLed";
-    resp["humiLed"] = glob_humi_led_enabled;
+    resp["humiLed"] = cfg.humiLedEnabled;
     sendRpcResponse(requestId, resp);
   }
 }
 
 static void setup_coreiot()
 {
-  Serial.println("[CoreIoT] Waiting for internet...");
+  LOGI(MQTT, "Waiting for internet...");
   if (xBinarySemaphoreInternet != nullptr)
   {
     // Chờ tối đa 30s, nếu không có internet thì vẫn chạy để reconnect sau
     xSemaphoreTake(xBinarySemaphoreInternet, pdMS_TO_TICKS(30000));
   }
-  Serial.println("[CoreIoT] Internet check done.");
+  LOGI(MQTT, "Internet check done.");
   client.setServer(CORE_IOT_SERVER.c_str(), CORE_IOT_PORT.toInt());
   client.setCallback(callback);
 }
@@ -166,33 +231,63 @@ static void reconnect()
 {
   if (!client.connected())
   {
-    Serial.print("[CoreIoT] Reconnecting...");
+    HEAP_TAG("mqtt_connect");
+    LOGI(MQTT, "Reconnecting...");
     String clientId = "ESP32-" + String(random(0xffff), HEX);
 
     if (client.connect(clientId.c_str(), CORE_IOT_TOKEN.c_str(), nullptr))
     {
-      Serial.println(" Connected!");
+      LOGI(MQTT, "Connected as %s", clientId);
       client.subscribe("v1/devices/me/rpc/request/+");
       publishLedStates();
     }
     else
     {
-      Serial.print(" Failed (rc=");
-      Serial.print(client.state());
-      Serial.println(")");
+      LOGW(MQTT, "Connect failed (rc=%d)", client.state());
       // Không delay 5s ở đây để tránh block các task khác quá lâu
       // Task loop sẽ lo việc chờ đợi
     }
   }
 }
 
+// Lúc đã tới lượt gửi nhưng chưa có frame mới: kiểm tra lại theo chu kỳ này
+#define MQTT_FRAME_POLL_MS  250
+
+// Ngủ tới khi socket MQTT có dữ liệu (RPC, PINGRESP) hoặc hết timeoutMs.
+// Thay cho vTaskDelay(10) cũ: không thức dậy khi không có việc.
+static void waitMqttReadable(uint32_t timeoutMs)
+{
+  // WiFiClient có thể đã đệm sẵn dữ liệu mà socket không còn báo nữa
+  if (espClient.available() > 0)
+    return;
+
+  int fd = espClient.fd();
+  if (fd < 0)
+  {
+    vTaskDelay(pdMS_TO_TICKS(timeoutMs));
+    return;
+  }
+
+  fd_set readSet;
+  FD_ZERO(&readSet);
+  FD_SET(fd, &readSet);
+  struct timeval tv;
+  tv.tv_sec  = timeoutMs / 1000;
+  tv.tv_usec = (timeoutMs % 1000) * 1000;
+  select(fd + 1, &readSet, nullptr, nullptr, &tv);
+}
+
 void coreiot_task(void *pvParameters)
 {
   setup_coreiot();
 
-  // Biến dùng cho timer không chặn (Non-blocking)
+  // Frame telemetry do telemetry_encoder serialize sẵn; chỉ gửi khi có frame mới
+  uint32_t lastSentSeq = 0;
+
+  // Khoảng cách tối thiểu giữa 2 lần gửi telemetry
   unsigned long lastTelemetrySend = 0;
-  const unsigned long TELEMETRY_INTERVAL = 5000; // 5 giây gửi 1 lần
+  const unsigned long TELEMETRY_INTERVAL = 5000;
+  unsigned long lastMetricsSend = 0;
 
   for (;;)
   {
@@ -207,28 +302,34 @@ void coreiot_task(void *pvParameters)
     }
     
     // [QUAN TRỌNG] Phải gọi hàm này liên tục để nhận tin nhắn RPC
+    TRACE_BEGIN("mqtt_loop");
     client.loop();
+    TRACE_END("mqtt_loop");
 
-    // Kiểm tra thời gian để gửi Telemetry (Không dùng delay)
     unsigned long now = millis();
     if (now - lastTelemetrySend > TELEMETRY_INTERVAL)
     {
-        lastTelemetrySend = now;
-
-        StaticJsonDocument<256> doc;
-        doc["temperature"] = glob_temperature;
-        doc["humidity"]    = glob_humidity;
-        doc["tiny_score"]  = tinyml_score;
-        doc["tiny_pred"]   = tinyml_pred_anomaly ? "ANOM" : "OK";
-        doc["tiny_gt"]     = tinyml_gt_anomaly   ? "ANOM" : "OK";
-        doc["tiny_acc"]    = tinyml_accuracy;
-
-        String payload;
-        serializeJson(doc, payload);
-        client.publish("v1/devices/me/telemetry", payload.c_str());
+        TelemetryFrame *frame = telemetryAcquireLatest();
+        if (frame != nullptr && frame->seq != lastSentSeq)
+        {
+            lastTelemetrySend = now;
+            lastSentSeq = frame->seq;
+            publishTelemetry(*frame);
+        }
+        telemetryRelease(frame);
+    }
+
+    if (now - lastMetricsSend >= METRICS_MQTT_PERIOD_MS)
+    {
+        lastMetricsSend = now;
+        publishMetrics();
     }
 
-    // Delay cực ngắn để nhường CPU cho các task khác, nhưng đủ nhanh để nhận RPC
-    vTaskDelay(pdMS_TO_TICKS(10));
+    // Ngủ tới khi có RPC hoặc tới lượt gửi telemetry kế tiếp.
+    // TELEMETRY_INTERVAL nhỏ hơn keepalive nên client.loop() vẫn kịp gửi PINGREQ.
+    unsigned long elapsed = millis() - lastTelemetrySend;
+    uint32_t waitMs = (elapsed > TELEMETRY_INTERVAL) ? MQTT_FRAME_POLL_MS
+                                                     : TELEMETRY_INTERVAL - elapsed + 1;
+    waitMqttReadable(waitMs);
   }
 }
\ No newline at end of file
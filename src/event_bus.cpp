@@ -0,0 +1,254 @@
+#include "event_bus.h"
+
+struct EventSubscription {
+  uint32_t               mask;
+  EventSubOptions        opts;
+  TaskHandle_t           owner;
+  QueueHandle_t          queue;               // EVENT_DELIVER_QUEUE
+  StaticQueue_t          queueBuf;
+  std::atomic<EventMsg *> latest[TOPIC_COUNT]; // EVENT_DELIVER_LATEST
+  std::atomic<bool>      ready;
+};
+
+static EventMsg          eventPool[EVENT_BUS_POOL_SIZE];
+static QueueHandle_t     eventFreeList = nullptr;
+static EventMsg         *eventFreeListStorage[EVENT_BUS_POOL_SIZE];
+static StaticQueue_t     eventFreeListBuf;
+
+// Bộ nhớ hàng đợi của mọi subscriber EVENT_DELIVER_QUEUE, cấp dần khi đăng ký
+static EventMsg         *eventQueueSlots[EVENT_BUS_QUEUE_SLOTS];
+static uint8_t           eventQueueSlotsUsed = 0;
+
+static EventSubscription eventSubs[EVENT_BUS_MAX_SUBSCRIBERS];
+static volatile uint8_t  eventSubReserved = 0;
+static portMUX_TYPE      eventSubMux = portMUX_INITIALIZER_UNLOCKED;
+
+static std::atomic<uint32_t> topicSeq[TOPIC_COUNT];
+
+static std::atomic<uint32_t> statPublished(0);
+static std::atomic<uint32_t> statDelivered(0);
+static std::atomic<uint32_t> statCoalesced(0);
+static std::atomic<uint32_t> statOverflowed(0);
+static std::atomic<uint32_t> statPoolEmpty(0);
+
+void eventBusBegin()
+{
+  if (eventFreeList != nullptr)
+    return;
+
+  // Free list là queue con trỏ: lấy / trả message an toàn từ mọi task
+  eventFreeList = xQueueCreateStatic(EVENT_BUS_POOL_SIZE, sizeof(EventMsg *),
+                                     (uint8_t *)eventFreeListStorage, &eventFreeListBuf);
+  for (int i = 0; i < EVENT_BUS_POOL_SIZE; ++i)
+  {
+    EventMsg *msg = &eventPool[i];
+    msg->refs.store(0, std::memory_order_relaxed);
+    xQueueSend(eventFreeList, &msg, 0);
+  }
+}
+
+EventSubscription *eventSubscribe(uint32_t topicMask, const EventSubOptions &opts)
+{
+  if (opts.delivery == EVENT_DELIVER_CALLBACK && opts.callback == nullptr)
+    return nullptr;
+
+  uint8_t depth = 0;
+  if (opts.delivery == EVENT_DELIVER_QUEUE)
+    depth = opts.queue_depth > 0 ? opts.queue_depth : 1;
+
+  // Giữ chỗ (subscription + ô hàng đợi) trong critical section, khởi tạo bên ngoài
+  int index = -1;
+  int slot  = -1;
+  portENTER_CRITICAL(&eventSubMux);
+  if (eventSubReserved < EVENT_BUS_MAX_SUBSCRIBERS &&
+      eventQueueSlotsUsed + depth <= EVENT_BUS_QUEUE_SLOTS)
+  {
+    index = eventSubReserved++;
+    slot  = eventQueueSlotsUsed;
+    eventQueueSlotsUsed += depth;
+  }
+  portEXIT_CRITICAL(&eventSubMux);
+
+  if (index < 0)
+  {
+    Serial.println("[EventBus] Too many subscribers");
+    return nullptr;
+  }
+
+  EventSubscription *sub = &eventSubs[index];
+  sub->mask  = topicMask;
+  sub->opts  = opts;
+  sub->owner = xTaskGetCurrentTaskHandle();
+  sub->queue = nullptr;
+  for (int t = 0; t < TOPIC_COUNT; ++t)
+    sub->latest[t].store(nullptr, std::memory_order_relaxed);
+
+  if (depth > 0)
+  {
+    sub->queue = xQueueCreateStatic(depth, sizeof(EventMsg *),
+                                    (uint8_t *)&eventQueueSlots[slot], &sub->queueBuf);
+  }
+
+  // Publisher chỉ giao cho subscription đã sẵn sàng
+  sub->ready.store(true, std::memory_order_release);
+  return sub;
+}
+
+EventSubscription *eventSubscribeLatest(uint32_t topicMask)
+{
+  EventSubOptions opts = {EVENT_DELIVER_LATEST, 0, EVENT_DROP_OLDEST, nullptr, nullptr};
+  return eventSubscribe(topicMask, opts);
+}
+
+EventSubscription *eventSubscribeQueue(uint32_t topicMask, uint8_t depth, EventOverflow overflow)
+{
+  EventSubOptions opts = {EVENT_DELIVER_QUEUE, depth, overflow, nullptr, nullptr};
+  return eventSubscribe(topicMask, opts);
+}
+
+EventSubscription *eventSubscribeCallback(uint32_t topicMask, EventCallback fn, void *ctx)
+{
+  EventSubOptions opts = {EVENT_DELIVER_CALLBACK, 0, EVENT_DROP_OLDEST, fn, ctx};
+  return eventSubscribe(topicMask, opts);
+}
+
+static void deliverQueue(EventSubscription *sub, EventMsg *msg)
+{
+  msg->refs.fetch_add(1, std::memory_order_relaxed);
+  if (xQueueSend(sub->queue, &msg, 0) == pdTRUE)
+  {
+    statDelivered++;
+    // Cho owner chờ nhiều nguồn bằng xTaskNotifyWait (ví dụ executor)
+    xTaskNotify(sub->owner, EVENT_BUS_NOTIFY_BIT, eSetBits);
+    return;
+  }
+
+  statOverflowed++;
+  if (sub->opts.overflow == EVENT_DROP_OLDEST)
+  {
+    EventMsg *old = nullptr;
+    if (xQueueReceive(sub->queue, &old, 0) == pdTRUE)
+      eventRelease(old);
+    if (xQueueSend(sub->queue, &msg, 0) == pdTRUE)
+    {
+      statDelivered++;
+      xTaskNotify(sub->owner, EVENT_BUS_NOTIFY_BIT, eSetBits);
+      return;
+    }
+  }
+  eventRelease(msg);
+}
+
+static void deliverLatest(EventSubscription *sub, EventMsg *msg)
+{
+  msg->refs.fetch_add(1, std::memory_order_relaxed);
+  EventMsg *old = sub->latest[msg->topic].exchange(msg, std::memory_order_acq_rel);
+  if (old != nullptr)
+  {
+    // Subscriber chưa kịp đọc message trước: chỉ giữ bản mới nhất
+    statCoalesced++;
+    eventRelease(old);
+  }
+  statDelivered++;
+  xTaskNotify(sub->owner, EVENT_BUS_NOTIFY_BIT, eSetBits);
+}
+
+bool eventPublish(uint8_t topic, const void *payload, size_t len)
+{
+  if (eventFreeList == nullptr || topic >= TOPIC_COUNT || len > EVENT_PAYLOAD_MAX)
+    return false;
+
+  EventMsg *msg = nullptr;
+  if (xQueueReceive(eventFreeList, &msg, 0) != pdTRUE)
+  {
+    statPoolEmpty++;
+    return false;
+  }
+
+  // Ref của chính publisher, trả lại sau khi giao xong
+  msg->refs.store(1, std::memory_order_relaxed);
+  msg->topic        = topic;
+  msg->len          = (uint8_t)len;
+  msg->seq          = topicSeq[topic].fetch_add(1, std::memory_order_relaxed) + 1;
+  msg->timestamp_ms = millis();
+  memcpy(msg->payload.bytes, payload, len);
+  statPublished++;
+
+  uint8_t count = eventSubReserved;
+  for (uint8_t i = 0; i < count; ++i)
+  {
+    EventSubscription *sub = &eventSubs[i];
+    if (!sub->ready.load(std::memory_order_acquire) || (sub->mask & TOPIC_MASK(topic)) == 0)
+      continue;
+
+    switch (sub->opts.delivery)
+    {
+    case EVENT_DELIVER_QUEUE:
+      deliverQueue(sub, msg);
+      break;
+    case EVENT_DELIVER_LATEST:
+      deliverLatest(sub, msg);
+      break;
+    case EVENT_DELIVER_CALLBACK:
+      sub->opts.callback(msg, sub->opts.ctx);
+      statDelivered++;
+      break;
+    }
+  }
+
+  eventRelease(msg);
+  return true;
+}
+
+EventMsg *eventReceive(EventSubscription *sub, TickType_t timeout)
+{
+  if (sub == nullptr)
+    return nullptr;
+
+  if (sub->opts.delivery == EVENT_DELIVER_QUEUE)
+  {
+    EventMsg *msg = nullptr;
+    return xQueueReceive(sub->queue, &msg, timeout) == pdTRUE ? msg : nullptr;
+  }
+
+  if (sub->opts.delivery != EVENT_DELIVER_LATEST)
+    return nullptr;
+
+  TickType_t start = xTaskGetTickCount();
+  for (;;)
+  {
+    for (uint8_t t = 0; t < TOPIC_COUNT; ++t)
+    {
+      if ((sub->mask & TOPIC_MASK(t)) == 0)
+        continue;
+      EventMsg *msg = sub->latest[t].exchange(nullptr, std::memory_order_acq_rel);
+      if (msg != nullptr)
+        return msg;
+    }
+
+    TickType_t elapsed = xTaskGetTickCount() - start;
+    if (timeout == 0 || (timeout != portMAX_DELAY && elapsed >= timeout))
+      return nullptr;
+
+    // Bit chỉ là tín hiệu "có thể có message"; ô latest mới là dữ liệu thật
+    TickType_t remaining = (timeout == portMAX_DELAY) ? portMAX_DELAY : timeout - elapsed;
+    xTaskNotifyWait(0, EVENT_BUS_NOTIFY_BIT, nullptr, remaining);
+  }
+}
+
+void eventRelease(EventMsg *msg)
+{
+  if (msg == nullptr)
+    return;
+  if (msg->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    xQueueSend(eventFreeList, &msg, 0);
+}
+
+void eventBusGetStats(EventBusStats &out)
+{
+  out.published  = statPublished.load(std::memory_order_relaxed);
+  out.delivered  = statDelivered.load(std::memory_order_relaxed);
+  out.coalesced  = statCoalesced.load(std::memory_order_relaxed);
+  out.overflowed = statOverflowed.load(std::memory_order_relaxed);
+  out.pool_empty = statPoolEmpty.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,175 @@
+#include "executor.h"
+#include <atomic>
+
+struct ExecJob {
+  const char *name;
+  uint32_t    topicMask;
+  ExecStepFn  step;
+  void       *ctx;
+
+  WheelTimer            timer;      // deadline của job trên timer wheel
+  std::atomic<bool>     due;        // timer / ISR đã báo, chờ executor chạy
+  bool                  awaiting;
+
+  uint32_t    runs;
+  uint32_t    maxRunUs;
+};
+
+static ExecJob jobs[EXECUTOR_MAX_JOBS];
+static uint8_t jobCount = 0;
+static TaskHandle_t executorHandle = nullptr;
+
+// Timer wheel gọi trong task esp_timer: chỉ đánh dấu rồi đánh thức executor
+static void onJobTimer(void *ctx)
+{
+  ExecJob *job = (ExecJob *)ctx;
+  job->due.store(true, std::memory_order_release);
+  xTaskNotify(executorHandle, EXECUTOR_TIMER_BIT, eSetBits);
+}
+
+ExecJob *executorAdd(const char *name, uint32_t topicMask, ExecStepFn step, void *ctx)
+{
+  if (step == nullptr || jobCount >= EXECUTOR_MAX_JOBS)
+  {
+    Serial.printf("[Executor] Không thêm được job %s\n", name);
+    return nullptr;
+  }
+
+  ExecJob &job = jobs[jobCount++];
+  job.name      = name;
+  job.topicMask = topicMask;
+  job.step      = step;
+  job.ctx       = ctx;
+  job.awaiting  = false;
+  job.runs      = 0;
+  job.maxRunUs  = 0;
+  wheelTimerInitCallback(job.timer, onJobTimer, &job);
+  job.due.store(true, std::memory_order_relaxed);   // chạy lần đầu ngay khi executor khởi động
+  return &job;
+}
+
+static void runJob(ExecJob &job, const EventMsg *msg)
+{
+  uint32_t start = micros();
+  uint32_t next  = job.step(msg, job.ctx);
+  uint32_t took  = micros() - start;
+
+  job.runs++;
+  if (took > job.maxRunUs)
+    job.maxRunUs = took;
+
+  if (next == EXEC_KEEP_TIMER)
+    return;
+
+  job.awaiting = (next == EXEC_AWAIT);
+  if (next == EXEC_WAIT_EVENT)
+  {
+    wheelTimerCancel(job.timer);
+  }
+  else if (next == 0)
+  {
+    // Chạy lại ngay ở vòng kế tiếp, không qua timer
+    wheelTimerCancel(job.timer);
+    job.due.store(true, std::memory_order_relaxed);
+  }
+  else
+  {
+    wheelTimerStart(job.timer, job.awaiting ? EXECUTOR_AWAIT_POLL_MS : next);
+  }
+}
+
+static void runAwaitingJobs()
+{
+  for (uint8_t i = 0; i < jobCount; ++i)
+  {
+    if (jobs[i].awaiting)
+      runJob(jobs[i], nullptr);
+  }
+}
+
+// Chạy mọi job đã được timer / ISR báo; true nếu có job chạy
+static bool runDueJobs()
+{
+  bool ran = false;
+  for (uint8_t i = 0; i < jobCount; ++i)
+  {
+    if (jobs[i].due.exchange(false, std::memory_order_acq_rel))
+    {
+      runJob(jobs[i], nullptr);
+      ran = true;
+    }
+  }
+  return ran;
+}
+
+void executor_task(void *pvParameters)
+{
+  executorHandle = xTaskGetCurrentTaskHandle();
+
+  // Một subscription kiểu QUEUE cho hợp mọi topic: không gộp mất sự kiện
+  // của job này chỉ vì job khác cùng nghe topic đó
+  uint32_t mask = 0;
+  for (uint8_t i = 0; i < jobCount; ++i)
+    mask |= jobs[i].topicMask;
+  EventSubscription *sub = mask ? eventSubscribeQueue(mask, EXECUTOR_QUEUE_DEPTH) : nullptr;
+
+  for (;;)
+  {
+    bool busy = runDueJobs();
+
+    // Phát sự kiện đang chờ cho các job đăng ký topic đó
+    EventMsg *msg;
+    while (sub != nullptr && (msg = eventReceive(sub, 0)) != nullptr)
+    {
+      for (uint8_t i = 0; i < jobCount; ++i)
+      {
+        if (jobs[i].topicMask & TOPIC_MASK(msg->topic))
+          runJob(jobs[i], msg);
+      }
+      eventRelease(msg);
+      busy = true;
+    }
+    if (busy)
+      continue;   // job có thể vừa yêu cầu chạy lại ngay
+
+    // Không có deadline nào ở đây: timer wheel và event bus đều đánh thức
+    // bằng notification
+    uint32_t bits = 0;
+    xTaskNotifyWait(0, 0xFFFFFFFFUL, &bits, portMAX_DELAY);
+    if (bits & ~EXECUTOR_TIMER_BIT)
+      runAwaitingJobs();
+  }
+}
+
+void executorSignal(ExecJob *job)
+{
+  if (job == nullptr || executorHandle == nullptr)
+    return;
+
+  job->due.store(true, std::memory_order_release);
+  xTaskNotify(executorHandle, EXECUTOR_TIMER_BIT, eSetBits);
+}
+
+void IRAM_ATTR executorSignalFromISR(ExecJob *job)
+{
+  if (job == nullptr || executorHandle == nullptr)
+    return;
+
+  BaseType_t woken = pdFALSE;
+  job->due.store(true, std::memory_order_release);
+  xTaskNotifyFromISR(executorHandle, EXECUTOR_TIMER_BIT, eSetBits, &woken);
+  if (woken == pdTRUE)
+    portYIELD_FROM_ISR();
+}
+
+void executorStatsToJson(JsonArray out)
+{
+  for (uint8_t i = 0; i < jobCount; ++i)
+  {
+    JsonObject o = out.createNestedObject();
+    o["name"]  = jobs[i].name;
+    o["runs"]  = jobs[i].runs;
+    o["maxUs"] = jobs[i].maxRunUs;
+    o["armed"] = wheelTimerActive(jobs[i].timer);
+  }
+}
@@ -0,0 +1,63 @@
+#include "fixed_point.h"
+#include "global.h"
+
+uint8_t mapBrightnessCenti(centi_t x, centi_t inMin, centi_t inMax,
+                           uint8_t outMin, uint8_t outMax)
+{
+  if (inMax == inMin)
+    return outMin;
+
+  if (x < inMin) x = inMin;
+  if (x > inMax) x = inMax;
+
+  // |Δin| <= 10000 (0..100 %RH), |Δout| <= 255 → tích vừa int32
+  int32_t val = outMin + (int32_t)(x - inMin) * ((int32_t)outMax - outMin) / (inMax - inMin);
+
+  if (val < 0)   val = 0;
+  if (val > 255) val = 255;
+  return (uint8_t)val;
+}
+
+size_t formatCenti(char *buf, size_t len, centi_t value, uint8_t decimals)
+{
+  static const int32_t divisors[] = {100, 10, 1};
+  if (decimals > 2)
+    decimals = 2;
+
+  bool negative = value < 0;
+  uint32_t mag = negative ? (uint32_t)(-value) : (uint32_t)value;
+
+  // Làm tròn về số chữ số lẻ yêu cầu
+  uint32_t unit = divisors[decimals];
+  mag = (mag + unit / 2) / unit;
+
+  uint32_t scale   = CENTI_SCALE / unit;
+  uint32_t whole   = mag / scale;
+  uint32_t frac    = mag % scale;
+
+  // Ghi ngược từ cuối vào bộ đệm tạm rồi chép ra
+  char tmp[16];
+  size_t n = 0;
+  for (uint8_t i = 0; i < decimals; ++i)
+  {
+    tmp[n++] = '0' + frac % 10;
+    frac /= 10;
+  }
+  if (decimals > 0)
+    tmp[n++] = '.';
+  do
+  {
+    tmp[n++] = '0' + whole % 10;
+    whole /= 10;
+  } while (whole > 0 && n < sizeof(tmp) - 1);
+  if (negative && mag != 0)
+    tmp[n++] = '-';
+
+  if (len == 0)
+    return 0;
+  size_t out = 0;
+  while (n > 0 && out < len - 1)
+    buf[out++] = tmp[--n];
+  buf[out] = '\0';
+  return out;
+}
@@ -1,43 +1,73 @@
 #include "global.h"
+#include <atomic>
+#include "fixed_point.h"
 
-// ====== Biến toàn cục cảm biến ======
-float glob_temperature = 0.0f;
-float glob_humidity    = 0.0f;
+// ====== Ảnh chụp cảm biến (seqlock) ======
+// Bộ đếm lẻ = writer đang ghi; reader đọc lại nếu bộ đếm đổi giữa chừng.
+static SensorSnapshot         sensorSnapshot = {0.0f, 0.0f, 0, 0, TEMP_LEVEL_NORMAL,
+                                                HUMI_LEVEL_OK, 0, 0};
+static std::atomic<uint32_t>  sensorSnapshotLock(0);
 
-// Mức nhiệt/ẩm & trạng thái hiển thị
-volatile uint8_t glob_temp_level     = TEMP_LEVEL_NORMAL;
-volatile uint8_t glob_humi_level     = HUMI_LEVEL_OK;
-volatile uint8_t glob_display_state  = DISPLAY_STATE_NORMAL;
+static void writeSensorSnapshot(float temperature, float humidity,
+                                int32_t tempCenti, int32_t humiCenti,
+                                uint8_t tempLevel, uint8_t humiLevel, uint32_t acquiredUs)
+{
+  uint32_t lock = sensorSnapshotLock.load(std::memory_order_relaxed);
+  sensorSnapshotLock.store(lock + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  sensorSnapshot.temperature  = temperature;
+  sensorSnapshot.humidity     = humidity;
+  sensorSnapshot.temp_centi   = (int16_t)constrain(tempCenti, -32000, 32000);
+  sensorSnapshot.humi_centi   = (int16_t)constrain(humiCenti, -32000, 32000);
+  sensorSnapshot.temp_level   = tempLevel;
+  sensorSnapshot.humi_level   = humiLevel;
+  sensorSnapshot.timestamp_ms = millis();
+  sensorSnapshot.acquired_us  = acquiredUs;
+  sensorSnapshot.seq++;
+
+  sensorSnapshotLock.store(lock + 2, std::memory_order_release);
+}
+
+void publishSensorSnapshot(float temperature, float humidity,
+                           uint8_t tempLevel, uint8_t humiLevel, uint32_t acquiredUs)
+{
+  writeSensorSnapshot(temperature, humidity,
+                      centiFromFloat(temperature), centiFromFloat(humidity),
+                      tempLevel, humiLevel, acquiredUs);
+}
+
+void publishSensorSnapshotCenti(int32_t tempCenti, int32_t humiCenti,
+                                uint8_t tempLevel, uint8_t humiLevel, uint32_t acquiredUs)
+{
+  writeSensorSnapshot(centiToFloat(tempCenti), centiToFloat(humiCenti),
+                      tempCenti, humiCenti, tempLevel, humiLevel, acquiredUs);
+}
+
+bool readSensorSnapshot(SensorSnapshot &out, uint32_t lastSeq)
+{
+  for (;;)
+  {
+    uint32_t before = sensorSnapshotLock.load(std::memory_order_acquire);
+    if (before & 1u)
+    {
+      // Writer đang ghi: nhường 1 tick để writer ưu tiên thấp hơn chạy xong
+      vTaskDelay(1);
+      continue;
+    }
 
-// ====== Ngưỡng runtime có thể chỉnh từ WebUI ======
-float tempColdThreshold  = TEMP_COLD_THRESHOLD;
-float tempHotThreshold   = TEMP_HOT_THRESHOLD;
-float humiDryThreshold   = HUMI_DRY_THRESHOLD;
-float humiHumidThreshold = HUMI_HUMID_THRESHOLD;
-
-// ====== Cấu hình nháy LED theo nhiệt độ (ms) ======
-TempLedConfig tempLedConfig[3] = {
-    {1000, 1000}, // LẠNH
-    {200, 800},  // BÌNH THƯỜNG
-    {150, 150}   // NÓNG 
-};
-
-// ====== Màu NeoPixel theo độ ẩm (RGB) ======
-NeoColorConfig neoColorConfig[3] = {
-    {0, 0, 255}, // DRY   → xanh dương
-    {0, 255, 0}, // OK    → xanh lá
-    {255, 0, 0}  // HUMID → đỏ
-};
-
-// ====== Bật/tắt hiển thị LED từ WebUI ======
-volatile bool glob_temp_led_enabled = true;
-volatile bool glob_humi_led_enabled = true;
-
-// ====== TinyML runtime result ======
-float tinyml_score        = 0.0f;
-float tinyml_accuracy     = 0.0f;
-bool  tinyml_pred_anomaly = false;
-bool  tinyml_gt_anomaly   = false;
+    out = sensorSnapshot;
+    std::atomic_thread_fence(std::memory_order_acquire);
+
+    if (sensorSnapshotLock.load(std::memory_order_relaxed) == before)
+      break;
+  }
+
+  return out.seq != lastSeq;
+}
+
+// Trạng thái hiển thị
+volatile uint8_t glob_display_state  = DISPLAY_STATE_NORMAL;
 
 // ====== WiFi / CoreIoT config ======
 String WIFI_SSID;
@@ -58,8 +88,5 @@ String wifi_password = "123456789";
 bool isWifiConnected = false;
 
 // ====== Semaphore cho Internet ) ======
-SemaphoreHandle_t xBinarySemaphoreInternet = xSemaphoreCreateBinary();
-
-// ====== Semaphore cho các task ======
-SemaphoreHandle_t xTempLedSemaphore = xSemaphoreCreateBinary();
-SemaphoreHandle_t xHumiNeoSemaphore = xSemaphoreCreateBinary();
+static StaticSemaphore_t xBinarySemaphoreInternetBuf;
+SemaphoreHandle_t xBinarySemaphoreInternet = xSemaphoreCreateBinaryStatic(&xBinarySemaphoreInternetBuf);
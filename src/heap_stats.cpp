@@ -0,0 +1,357 @@
+#include "heap_stats.h"
+
+#ifdef HEAP_STATS
+
+#include <esp_heap_caps.h>
+#include <reent.h>
+
+// Hàm gốc, linker nối tới nhờ -Wl,--wrap=<tên>
+extern "C" {
+void *__real_malloc(size_t size);
+void  __real_free(void *ptr);
+void *__real_calloc(size_t n, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+void *__real__malloc_r(struct _reent *r, size_t size);
+void  __real__free_r(struct _reent *r, void *ptr);
+void *__real__calloc_r(struct _reent *r, size_t n, size_t size);
+void *__real__realloc_r(struct _reent *r, void *ptr, size_t size);
+}
+
+struct HeapCounters {
+  uint32_t allocs;
+  uint32_t frees;
+  uint32_t allocBytes;
+  uint32_t freeBytes;
+  uint32_t failed;
+};
+
+struct TaskHeapEntry {
+  TaskHandle_t task;     // nullptr ở dòng 0: trước scheduler / ISR / tràn bảng
+  bool         dead;     // task đã kết thúc: giữ số liệu, handle không còn khớp
+  const char  *tag;      // tag hiện tại của task (HEAP_TAG)
+  char         name[configMAX_TASK_NAME_LEN];   // chép lúc tạo dòng
+  HeapCounters c;
+};
+
+struct TagHeapEntry {
+  const char  *tag;      // nullptr ở dòng 0: không có tag / tràn bảng
+  HeapCounters c;
+};
+
+// Bảng cố định, không cấp phát; mọi truy cập dưới heapStatsMux.
+// Hàm cấp phát gốc luôn chạy NGOÀI critical section.
+//
+// malloc / free của newlib nằm trong IRAM để chạy được cả khi cache flash bị
+// tắt (ghi flash, WiFi OSI _malloc / _free); mọi hàm trên đường cấp phát ở đây
+// cũng phải IRAM_ATTR và chỉ đụng tới dữ liệu trong DRAM.
+static TaskHeapEntry taskEntries[HEAP_STATS_MAX_TASKS];
+static TagHeapEntry  tagEntries[HEAP_STATS_MAX_TAGS];
+static uint8_t       taskCount = 1;
+static uint8_t       tagCount  = 1;
+static portMUX_TYPE  heapStatsMux = portMUX_INITIALIZER_UNLOCKED;
+
+static void IRAM_ATTR addCounters(HeapCounters &sum, const HeapCounters &c)
+{
+  sum.allocs     += c.allocs;
+  sum.frees      += c.frees;
+  sum.allocBytes += c.allocBytes;
+  sum.freeBytes  += c.freeBytes;
+  sum.failed     += c.failed;
+}
+
+// ====== Tra bảng (gọi khi đang giữ mux) ======
+// Dòng cho task mới: ô trống, hết ô thì gộp một dòng đã chết vào dòng 0
+static TaskHeapEntry *IRAM_ATTR newTaskEntry()
+{
+  if (taskCount < HEAP_STATS_MAX_TASKS)
+    return &taskEntries[taskCount++];
+
+  for (uint8_t i = 1; i < taskCount; ++i)
+  {
+    if (taskEntries[i].dead)
+    {
+      addCounters(taskEntries[0].c, taskEntries[i].c);
+      return &taskEntries[i];
+    }
+  }
+  return nullptr;
+}
+
+static TaskHeapEntry &IRAM_ATTR taskEntry()
+{
+  if (xPortInIsrContext())
+    return taskEntries[0];
+  TaskHandle_t self = xTaskGetCurrentTaskHandle();
+  if (self == nullptr)
+    return taskEntries[0];
+
+  for (uint8_t i = 1; i < taskCount; ++i)
+  {
+    if (taskEntries[i].task == self && !taskEntries[i].dead)
+      return taskEntries[i];
+  }
+
+  TaskHeapEntry *e = newTaskEntry();
+  if (e == nullptr)
+    return taskEntries[0];
+
+  memset(e, 0, sizeof(*e));
+  e->task = self;
+  // Tên chép ngay: task có thể bị xoá trước lần báo cáo kế tiếp
+  const char *name = pcTaskGetTaskName(self);
+  for (size_t k = 0; k + 1 < sizeof(e->name) && name[k] != '\0'; ++k)
+    e->name[k] = name[k];
+  return *e;
+}
+
+static TagHeapEntry &IRAM_ATTR tagEntry(const char *tag)
+{
+  if (tag == nullptr)
+    return tagEntries[0];
+
+  for (uint8_t i = 1; i < tagCount; ++i)
+  {
+    if (tagEntries[i].tag == tag)
+      return tagEntries[i];
+  }
+  if (tagCount >= HEAP_STATS_MAX_TAGS)
+    return tagEntries[0];
+
+  TagHeapEntry &e = tagEntries[tagCount++];
+  e.tag = tag;
+  return e;
+}
+
+// ====== Ghi nhận ======
+static void IRAM_ATTR recordAlloc(void *ptr, size_t size)
+{
+  portENTER_CRITICAL(&heapStatsMux);
+  TaskHeapEntry &t = taskEntry();
+  TagHeapEntry &g = tagEntry(t.tag);
+  if (ptr == nullptr)
+  {
+    t.c.failed++;
+    g.c.failed++;
+  }
+  else
+  {
+    t.c.allocs++;
+    g.c.allocs++;
+    t.c.allocBytes += size;
+    g.c.allocBytes += size;
+  }
+  portEXIT_CRITICAL(&heapStatsMux);
+}
+
+static void IRAM_ATTR recordFree(size_t size)
+{
+  portENTER_CRITICAL(&heapStatsMux);
+  TaskHeapEntry &t = taskEntry();
+  TagHeapEntry &g = tagEntry(t.tag);
+  t.c.frees++;
+  g.c.frees++;
+  t.c.freeBytes += size;
+  g.c.freeBytes += size;
+  portEXIT_CRITICAL(&heapStatsMux);
+}
+
+// realloc = trả khối cũ + cấp khối mới (nếu có)
+static void IRAM_ATTR recordRealloc(void *oldPtr, size_t oldSize, void *newPtr, size_t size)
+{
+  if (oldPtr != nullptr && (newPtr != nullptr || size == 0))
+    recordFree(oldSize);
+  if (size != 0)
+    recordAlloc(newPtr, size);
+}
+
+static inline size_t IRAM_ATTR blockSize(void *ptr)
+{
+  return ptr ? heap_caps_get_allocated_size(ptr) : 0;
+}
+
+// ====== Wrapper ======
+extern "C" {
+
+void *IRAM_ATTR __wrap_malloc(size_t size)
+{
+  void *p = __real_malloc(size);
+  recordAlloc(p, size);
+  return p;
+}
+
+void IRAM_ATTR __wrap_free(void *ptr)
+{
+  if (ptr == nullptr)
+    return;
+  recordFree(blockSize(ptr));
+  __real_free(ptr);
+}
+
+void *IRAM_ATTR __wrap_calloc(size_t n, size_t size)
+{
+  void *p = __real_calloc(n, size);
+  recordAlloc(p, n * size);
+  return p;
+}
+
+void *IRAM_ATTR __wrap_realloc(void *ptr, size_t size)
+{
+  size_t oldSize = blockSize(ptr);
+  void *p = __real_realloc(ptr, size);
+  recordRealloc(ptr, oldSize, p, size);
+  return p;
+}
+
+// Bản reentrant của newlib (strdup, printf, ...)
+void *IRAM_ATTR __wrap__malloc_r(struct _reent *r, size_t size)
+{
+  void *p = __real__malloc_r(r, size);
+  recordAlloc(p, size);
+  return p;
+}
+
+void IRAM_ATTR __wrap__free_r(struct _reent *r, void *ptr)
+{
+  if (ptr == nullptr)
+    return;
+  recordFree(blockSize(ptr));
+  __real__free_r(r, ptr);
+}
+
+void *IRAM_ATTR __wrap__calloc_r(struct _reent *r, size_t n, size_t size)
+{
+  void *p = __real__calloc_r(r, n, size);
+  recordAlloc(p, n * size);
+  return p;
+}
+
+void *IRAM_ATTR __wrap__realloc_r(struct _reent *r, void *ptr, size_t size)
+{
+  size_t oldSize = blockSize(ptr);
+  void *p = __real__realloc_r(r, ptr, size);
+  recordRealloc(ptr, oldSize, p, size);
+  return p;
+}
+
+}
+
+// ====== Tag ======
+HeapTagScope::HeapTagScope(const char *tag)
+{
+  portENTER_CRITICAL(&heapStatsMux);
+  TaskHeapEntry &t = taskEntry();
+  _prev = t.tag;
+  t.tag = tag;
+  portEXIT_CRITICAL(&heapStatsMux);
+}
+
+HeapTagScope::~HeapTagScope()
+{
+  portENTER_CRITICAL(&heapStatsMux);
+  taskEntry().tag = _prev;
+  portEXIT_CRITICAL(&heapStatsMux);
+}
+
+// ====== Báo cáo ======
+static void countersToJson(JsonObject o, const HeapCounters &c)
+{
+  o["allocs"]     = c.allocs;
+  o["frees"]      = c.frees;
+  o["allocBytes"] = c.allocBytes;
+  o["freeBytes"]  = c.freeBytes;
+  o["failed"]     = c.failed;
+}
+
+static void totals(HeapCounters &sum)
+{
+  memset(&sum, 0, sizeof(sum));
+  portENTER_CRITICAL(&heapStatsMux);
+  for (uint8_t i = 0; i < taskCount; ++i)
+    addCounters(sum, taskEntries[i].c);
+  portEXIT_CRITICAL(&heapStatsMux);
+}
+
+// Dòng có handle không còn trong danh sách task đang sống, hoặc handle đã bị
+// task khác (tên khác) dùng lại, được đánh dấu chết để task mới ở cùng địa chỉ
+// TCB không thừa hưởng số liệu cũ. Gọi khi đang giữ mux.
+static void markDeadTasks(const TaskStatus_t *status, UBaseType_t alive)
+{
+  for (uint8_t i = 1; i < taskCount; ++i)
+  {
+    TaskHeapEntry &e = taskEntries[i];
+    if (e.dead)
+      continue;
+    bool live = false;
+    for (UBaseType_t k = 0; k < alive; ++k)
+    {
+      if (status[k].xHandle == e.task)
+      {
+        live = strncmp(status[k].pcTaskName, e.name, sizeof(e.name)) == 0;
+        break;
+      }
+    }
+    e.dead = !live;
+  }
+}
+
+void heapStatsToJson(JsonObject out)
+{
+  // Danh sách task lấy trước: nó cấp phát, không được làm khi giữ mux
+  TaskStatus_t *status = nullptr;
+  UBaseType_t alive = 0;
+#if configUSE_TRACE_FACILITY
+  UBaseType_t capacity = uxTaskGetNumberOfTasks() + 4;
+  status = (TaskStatus_t *)malloc(capacity * sizeof(TaskStatus_t));
+  if (status != nullptr)
+    alive = uxTaskGetSystemState(status, capacity, nullptr);
+#endif
+
+  // Chép bảng ra trước: dựng JSON sẽ cấp phát, không được làm khi giữ mux
+  TaskHeapEntry tasks[HEAP_STATS_MAX_TASKS];
+  TagHeapEntry  tags[HEAP_STATS_MAX_TAGS];
+  portENTER_CRITICAL(&heapStatsMux);
+  if (status != nullptr)
+    markDeadTasks(status, alive);
+  uint8_t nTasks = taskCount;
+  uint8_t nTags  = tagCount;
+  memcpy(tasks, taskEntries, nTasks * sizeof(TaskHeapEntry));
+  memcpy(tags, tagEntries, nTags * sizeof(TagHeapEntry));
+  portEXIT_CRITICAL(&heapStatsMux);
+  free(status);
+
+  HeapCounters sum;
+  memset(&sum, 0, sizeof(sum));
+  for (uint8_t i = 0; i < nTasks; ++i)
+    addCounters(sum, tasks[i].c);
+  countersToJson(out.createNestedObject("total"), sum);
+
+  // Tên chép lúc tạo dòng: handle của task đã xoá không được đọc lại
+  JsonArray ta = out.createNestedArray("tasks");
+  for (uint8_t i = 0; i < nTasks; ++i)
+  {
+    JsonObject o = ta.createNestedObject();
+    o["name"] = (i == 0) ? "other" : tasks[i].name;
+    if (i > 0)
+      o["alive"] = !tasks[i].dead;
+    countersToJson(o, tasks[i].c);
+  }
+
+  JsonArray ga = out.createNestedArray("tags");
+  for (uint8_t i = 0; i < nTags; ++i)
+  {
+    JsonObject o = ga.createNestedObject();
+    o["tag"] = i > 0 ? tags[i].tag : "untagged";
+    countersToJson(o, tags[i].c);
+  }
+}
+
+void heapStatsSummaryToJson(JsonObject out)
+{
+  HeapCounters sum;
+  totals(sum);
+  out["allocs"]     = sum.allocs;
+  out["frees"]      = sum.frees;
+  out["allocBytes"] = sum.allocBytes;
+}
+
+#endif
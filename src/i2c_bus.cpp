@@ -0,0 +1,245 @@
+#include "i2c_bus.h"
+#include "logger.h"
+
+#define I2C_BUS_QUEUE_LEN    8
+// Bit notification dành riêng cho việc báo job I2C đã xong
+#define I2C_BUS_NOTIFY_BIT   (1UL << 31)
+
+struct I2cJob {
+  I2cJobFn      fn;
+  void         *arg;
+  uint32_t      clock_hz;
+  uint32_t      timeout_ms;
+  uint32_t      enqueued_us;
+  TaskHandle_t  caller;
+  volatile bool *result;
+};
+
+struct I2cRawTransfer {
+  uint8_t        addr;
+  const uint8_t *tx;
+  size_t         tx_len;
+  uint8_t       *rx;
+  size_t         rx_len;
+};
+
+static uint8_t       i2cQueueStorage[I2C_BUS_QUEUE_LEN * sizeof(I2cJob)];
+static StaticQueue_t i2cQueueBuf;
+static QueueHandle_t i2cQueue = xQueueCreateStatic(I2C_BUS_QUEUE_LEN, sizeof(I2cJob),
+                                                   i2cQueueStorage, &i2cQueueBuf);
+
+static I2cBusStats  busStats = {0, 0, 0, 0, 0, 0, 0};
+static portMUX_TYPE busStatsMux = portMUX_INITIALIZER_UNLOCKED;
+
+// Job hiện tại báo Wire timeout / lỗi bus; chỉ task bus đọc / ghi
+static bool jobWireFault = false;
+
+void i2cBusNoteWireError(int err)
+{
+  if (err == I2C_WIRE_ERR_OTHER || err == I2C_WIRE_ERR_TIMEOUT)
+    jobWireFault = true;
+}
+
+// Bus rảnh thì SDA ở mức cao; đọc vài lần để không bắt nhầm một bit đang truyền
+static bool sdaHeldLow()
+{
+  for (int i = 0; i < 3; ++i)
+  {
+    if (digitalRead(I2C_SDA_PIN) == HIGH)
+      return false;
+    delayMicroseconds(10);
+  }
+  return true;
+}
+
+// Gỡ bus khi thiết bị slave giữ SDA ở mức thấp (treo giữa chừng 1 byte):
+// phát tối đa 9 xung SCL cho tới khi SDA được nhả, rồi tạo điều kiện STOP.
+// Trả về true nếu SDA đã được nhả.
+static bool recoverBus(uint32_t clockHz)
+{
+  Wire.end();
+
+  pinMode(I2C_SDA_PIN, INPUT_PULLUP);
+  pinMode(I2C_SCL_PIN, OUTPUT_OPEN_DRAIN);
+  digitalWrite(I2C_SCL_PIN, HIGH);
+  delayMicroseconds(5);
+
+  for (int i = 0; i < 9 && digitalRead(I2C_SDA_PIN) == LOW; ++i)
+  {
+    digitalWrite(I2C_SCL_PIN, LOW);
+    delayMicroseconds(5);
+    digitalWrite(I2C_SCL_PIN, HIGH);
+    delayMicroseconds(5);
+  }
+
+  // STOP: SDA đi lên trong khi SCL đang cao
+  pinMode(I2C_SDA_PIN, OUTPUT_OPEN_DRAIN);
+  digitalWrite(I2C_SDA_PIN, LOW);
+  delayMicroseconds(5);
+  digitalWrite(I2C_SCL_PIN, HIGH);
+  delayMicroseconds(5);
+  digitalWrite(I2C_SDA_PIN, HIGH);
+  delayMicroseconds(5);
+
+  bool released = digitalRead(I2C_SDA_PIN) == HIGH;
+
+  Wire.begin(I2C_SDA_PIN, I2C_SCL_PIN, clockHz);
+  Wire.setTimeOut(I2C_BUS_WIRE_TIMEOUT_MS);
+
+  LOGW(BUS, "I2C bus recovery (SDA %s)", released ? "released" : "still low");
+  return released;
+}
+
+void i2c_bus_task(void *pvParameters)
+{
+  uint32_t clockHz = I2C_BUS_STD_HZ;
+  Wire.begin(I2C_SDA_PIN, I2C_SCL_PIN, clockHz);
+  Wire.setTimeOut(I2C_BUS_WIRE_TIMEOUT_MS);
+
+  uint8_t  consecutiveFaults = 0;
+  bool     recoveredSinceOk  = false;   // đã gỡ bus mà chưa có job nào thành công
+  uint32_t backoffMs         = 0;
+  uint32_t recoverNotBefore  = 0;
+  I2cJob job;
+
+  for (;;)
+  {
+    if (xQueueReceive(i2cQueue, &job, portMAX_DELAY) != pdTRUE)
+      continue;
+
+    uint32_t start  = micros();
+    uint32_t waited = start - job.enqueued_us;
+    bool ran = false;
+    bool ok  = false;
+
+    // Job đã quá hạn trong hàng đợi: trả lỗi luôn, không chiếm bus nữa
+    if (waited <= job.timeout_ms * 1000UL)
+    {
+      if (job.clock_hz != 0 && job.clock_hz != clockHz)
+      {
+        clockHz = job.clock_hz;
+        Wire.setClock(clockHz);
+      }
+      jobWireFault = false;
+      ok  = job.fn(Wire, job.arg);
+      ran = true;
+    }
+    uint32_t elapsed = micros() - start;
+
+    portENTER_CRITICAL(&busStatsMux);
+    busStats.jobs++;
+    if (!ran) busStats.timeouts++;
+    else if (!ok) busStats.failures++;
+    if (elapsed > busStats.max_job_us)  busStats.max_job_us  = elapsed;
+    if (waited  > busStats.max_wait_us) busStats.max_wait_us = waited;
+    portEXIT_CRITICAL(&busStatsMux);
+
+    *job.result = ok;
+    xTaskNotify(job.caller, I2C_BUS_NOTIFY_BIT, eSetBits);
+
+    if (!ran)
+      continue;
+
+    if (ok)
+    {
+      consecutiveFaults = 0;
+      recoveredSinceOk  = false;
+      backoffMs         = 0;
+      continue;
+    }
+
+    // NACK / thiết bị vắng mặt: bus vẫn rảnh, không gỡ
+    if (!jobWireFault && !sdaHeldLow())
+      continue;
+
+    if (++consecutiveFaults < I2C_BUS_RECOVER_AFTER ||
+        (int32_t)(millis() - recoverNotBefore) < 0)
+      continue;
+
+    bool released = recoverBus(clockHz);
+    consecutiveFaults = 0;
+
+    // Lần gỡ trước không giúp được (hoặc lần này SDA vẫn thấp) → lùi dần
+    bool helped = released && !recoveredSinceOk;
+    if (!helped)
+      backoffMs = backoffMs == 0 ? I2C_BUS_BACKOFF_MIN_MS
+                                 : min(backoffMs * 2, (uint32_t)I2C_BUS_BACKOFF_MAX_MS);
+    recoverNotBefore = millis() + backoffMs;
+    recoveredSinceOk = true;
+
+    portENTER_CRITICAL(&busStatsMux);
+    busStats.recoveries++;
+    if (!helped) busStats.recover_failed++;
+    portEXIT_CRITICAL(&busStatsMux);
+  }
+}
+
+bool i2cBusRun(I2cJobFn fn, void *arg, uint32_t clockHz, uint32_t timeoutMs)
+{
+  if (i2cQueue == nullptr || fn == nullptr)
+    return false;
+
+  volatile bool result = false;
+  I2cJob job = {fn, arg, clockHz, timeoutMs, micros(),
+                xTaskGetCurrentTaskHandle(), &result};
+
+  if (xQueueSend(i2cQueue, &job, pdMS_TO_TICKS(timeoutMs)) != pdTRUE)
+  {
+    portENTER_CRITICAL(&busStatsMux);
+    busStats.timeouts++;
+    portEXIT_CRITICAL(&busStatsMux);
+    return false;
+  }
+
+  // Bus task luôn trả lời (chạy xong hoặc bỏ job quá hạn) nên chờ không giới hạn
+  // là an toàn: job và result nằm trên stack của caller cho tới khi được báo.
+  uint32_t bits = 0;
+  do
+  {
+    xTaskNotifyWait(0, I2C_BUS_NOTIFY_BIT, &bits, portMAX_DELAY);
+  } while ((bits & I2C_BUS_NOTIFY_BIT) == 0);
+
+  return result;
+}
+
+static bool rawTransferJob(TwoWire &wire, void *arg)
+{
+  I2cRawTransfer *xfer = (I2cRawTransfer *)arg;
+
+  if (xfer->tx_len > 0)
+  {
+    wire.beginTransmission(xfer->addr);
+    wire.write(xfer->tx, xfer->tx_len);
+    uint8_t err = wire.endTransmission(xfer->rx_len == 0);
+    if (err != 0)
+    {
+      i2cBusNoteWireError(err);
+      return false;
+    }
+  }
+
+  if (xfer->rx_len > 0)
+  {
+    size_t got = wire.requestFrom(xfer->addr, (uint8_t)xfer->rx_len);
+    if (got < xfer->rx_len)
+      return false;
+    for (size_t i = 0; i < xfer->rx_len; ++i)
+      xfer->rx[i] = (uint8_t)wire.read();
+  }
+  return true;
+}
+
+bool i2cBusWriteRead(uint8_t addr, const uint8_t *tx, size_t txLen,
+                     uint8_t *rx, size_t rxLen,
+                     uint32_t clockHz, uint32_t timeoutMs)
+{
+  I2cRawTransfer xfer = {addr, tx, txLen, rx, rxLen};
+  return i2cBusRun(rawTransferJob, &xfer, clockHz, timeoutMs);
+}
+
+void i2cBusGetStats(I2cBusStats &out)
+{
+  portENTER_CRITICAL(&busStatsMux);
+  out = busStats;
+  portEXIT_CRITICAL(&busStatsMux);
+}
@@ -0,0 +1,105 @@
+#include "latency.h"
+#include <esp_timer.h>
+
+static LatencyHistogram sinkHistograms[LATENCY_SINK_COUNT];
+
+// Tên khoá JSON theo LatencySink
+static const char *const sinkNames[LATENCY_SINK_COUNT] = {"ws", "mqtt", "lcd"};
+static const char *const sinkP50[LATENCY_SINK_COUNT]   = {"wsP50", "mqttP50", "lcdP50"};
+static const char *const sinkP99[LATENCY_SINK_COUNT]   = {"wsP99", "mqttP99", "lcdP99"};
+static const char *const sinkMax[LATENCY_SINK_COUNT]   = {"wsMax", "mqttMax", "lcdMax"};
+
+LatencyHistogram::LatencyHistogram()
+{
+  _mux = portMUX_INITIALIZER_UNLOCKED;
+  memset(&_data, 0, sizeof(_data));
+}
+
+void LatencyHistogram::record(uint32_t us)
+{
+  // Chỉ số bucket = vị trí bit cao nhất
+  uint8_t bucket = us ? (uint8_t)(31 - __builtin_clz(us)) : 0;
+
+  portENTER_CRITICAL(&_mux);
+  _data.hist[bucket]++;
+  _data.count++;
+  if (us > _data.max)
+    _data.max = us;
+  portEXIT_CRITICAL(&_mux);
+}
+
+void LatencyHistogram::snapshot(Snapshot &out)
+{
+  portENTER_CRITICAL(&_mux);
+  out = _data;
+  portEXIT_CRITICAL(&_mux);
+}
+
+uint32_t LatencyHistogram::percentileOf(const Snapshot &s, uint8_t pct)
+{
+  if (s.count == 0)
+    return 0;
+
+  // Hạng của phân vị, làm tròn lên: p99 của 10 mẫu là mẫu thứ 10
+  uint32_t rank = (uint32_t)(((uint64_t)s.count * pct + 99) / 100);
+  if (rank == 0)
+    rank = 1;
+
+  uint32_t seen = 0;
+  for (uint8_t k = 0; k < LATENCY_BUCKETS; ++k)
+  {
+    seen += s.hist[k];
+    if (seen >= rank)
+    {
+      uint32_t upper = (k == 31) ? UINT32_MAX : ((1u << (k + 1)) - 1);
+      return upper < s.max ? upper : s.max;
+    }
+  }
+  return s.max;
+}
+
+void LatencyHistogram::summary(LatencySummary &out)
+{
+  Snapshot s;
+  snapshot(s);
+
+  out.count = s.count;
+  out.p50   = percentileOf(s, 50);
+  out.p99   = percentileOf(s, 99);
+  out.max   = s.max;
+}
+
+void LatencyHistogram::toJson(JsonObject out)
+{
+  LatencySummary s;
+  summary(s);
+
+  out["count"] = s.count;
+  out["p50"]   = s.p50;
+  out["p99"]   = s.p99;
+  out["max"]   = s.max;
+}
+
+void latencyRecord(LatencySink sink, uint32_t acquiredUs)
+{
+  // Hiệu 32 bit vẫn đúng khi esp_timer quay vòng giữa hai mốc
+  sinkHistograms[sink].record((uint32_t)esp_timer_get_time() - acquiredUs);
+}
+
+void latencyToJson(JsonObject out)
+{
+  for (uint8_t i = 0; i < LATENCY_SINK_COUNT; ++i)
+    sinkHistograms[i].toJson(out.createNestedObject(sinkNames[i]));
+}
+
+void latencySummaryToJson(JsonObject out)
+{
+  for (uint8_t i = 0; i < LATENCY_SINK_COUNT; ++i)
+  {
+    LatencySummary s;
+    sinkHistograms[i].summary(s);
+    out[sinkP50[i]] = s.p50;
+    out[sinkP99[i]] = s.p99;
+    out[sinkMax[i]] = s.max;
+  }
+}
@@ -1,82 +1,102 @@
 #include "led_blinky.h"
+#include "executor.h"
+#include "runtime_config.h"
 
-static void blinkPatternCold();
-static void blinkPatternNormal();
-static void blinkPatternHot();
+// Pha của một nhịp nháy: SÁNG → TẮT (→ NGHỈ sau chuỗi nhịp của mức NÓNG)
+enum LedPhase : uint8_t {
+  LED_PHASE_ON = 0,
+  LED_PHASE_OFF,
+  LED_PHASE_PAUSE
+};
 
-void led_blinky(void *pvParameters)
-{
-  pinMode(LED_GPIO, OUTPUT);
+#define LED_HOT_BLINKS    3
+#define LED_HOT_PAUSE_MS  700
 
-  uint8_t currentLevel = glob_temp_level;
+static uint8_t  currentLevel = TEMP_LEVEL_NORMAL;
+static LedPhase phase        = LED_PHASE_ON;
+static uint8_t  blinkCount   = 0;
+static RuntimeConfig config;   // chép lại khi version đổi
 
-  for (;;)
+// Áp dụng sự kiện; true nếu pattern đang chạy cần vẽ lại từ đầu
+static bool applyEvent(const EventMsg *msg)
+{
+  if (msg->topic == TOPIC_LEVEL_CHANGE)
   {
-    // Nếu người dùng tắt LED từ web => giữ tắt và bỏ qua pattern
-    if (!glob_temp_led_enabled)
-    {
-      digitalWrite(LED_GPIO, LOW);
-      vTaskDelay(pdMS_TO_TICKS(100));
-      continue;
-    }
-
-    // Nếu có thông báo mức nhiệt mới => cập nhật pattern
-    if (xTempLedSemaphore != nullptr && xSemaphoreTake(xTempLedSemaphore, 0) == pdTRUE)
-    {
-      currentLevel = glob_temp_level;
-    }
+    const LevelChangeEvent &ev = msg->as<LevelChangeEvent>();
+    if ((ev.changed & LEVEL_CHANGED_TEMP) == 0)
+      return false;
+    currentLevel = ev.temp_level;
+    return true;
+  }
 
-    switch (currentLevel)
-    {
-    case TEMP_LEVEL_COLD:
-      // Lạnh
-      blinkPatternCold();
-      break;
-    case TEMP_LEVEL_HOT:
-      // Nóng
-      blinkPatternHot();
-      break;
-    case TEMP_LEVEL_NORMAL:
-    default:
-      // Bình thường
-      blinkPatternNormal();
-      break;
-    }
+  if (msg->topic == TOPIC_CONFIG_CHANGE)
+  {
+    uint8_t section = msg->as<ConfigChangeEvent>().section;
+    return section == CONFIG_LED_PATTERN || section == CONFIG_DEVICE_ENABLE;
   }
+  return false;
 }
 
-// LẠNH
-static void blinkPatternCold()
+// LẠNH / BÌNH THƯỜNG: 1 nhịp lặp lại.
+// NÓNG: 3 nhịp rồi nghỉ 700 ms.
+static uint32_t ledStep(const EventMsg *msg, void *ctx)
 {
-  TempLedConfig cfg = tempLedConfig[TEMP_LEVEL_COLD];
-  digitalWrite(LED_GPIO, HIGH);
-  vTaskDelay(pdMS_TO_TICKS(cfg.on_ms));
-  digitalWrite(LED_GPIO, LOW);
-  vTaskDelay(pdMS_TO_TICKS(cfg.off_ms));
-}
+  if (msg != nullptr)
+  {
+    if (!applyEvent(msg))
+      return EXEC_KEEP_TIMER;
+    phase      = LED_PHASE_ON;
+    blinkCount = 0;
+  }
+  runtimeConfigRead(config, config.version);
 
-// BÌNH THƯỜNG
-static void blinkPatternNormal()
-{
-  TempLedConfig cfg = tempLedConfig[TEMP_LEVEL_NORMAL];
-  digitalWrite(LED_GPIO, HIGH);
-  vTaskDelay(pdMS_TO_TICKS(cfg.on_ms));
-  digitalWrite(LED_GPIO, LOW);
-  vTaskDelay(pdMS_TO_TICKS(cfg.off_ms));
-}
+  // Nếu người dùng tắt LED từ web => giữ tắt, chỉ chạy lại khi có thay đổi
+  if (!config.tempLedEnabled)
+  {
+    digitalWrite(LED_GPIO, LOW);
+    return EXEC_WAIT_EVENT;
+  }
 
-// NÓNG
-static void blinkPatternHot()
-{
-  TempLedConfig cfg = tempLedConfig[TEMP_LEVEL_HOT];
+  const TempLedConfig &cfg = config.tempLed[currentLevel];
+  uint8_t blinks = (currentLevel == TEMP_LEVEL_HOT) ? LED_HOT_BLINKS : 1;
 
-  for (int i = 0; i < 3; ++i)
+  switch (phase)
   {
+  case LED_PHASE_ON:
     digitalWrite(LED_GPIO, HIGH);
-    vTaskDelay(pdMS_TO_TICKS(cfg.on_ms));
+    phase = LED_PHASE_OFF;
+    return cfg.on_ms;
+
+  case LED_PHASE_OFF:
     digitalWrite(LED_GPIO, LOW);
-    vTaskDelay(pdMS_TO_TICKS(cfg.off_ms));
+    if (++blinkCount < blinks)
+    {
+      phase = LED_PHASE_ON;
+    }
+    else
+    {
+      blinkCount = 0;
+      phase = (currentLevel == TEMP_LEVEL_HOT) ? LED_PHASE_PAUSE : LED_PHASE_ON;
+    }
+    return cfg.off_ms;
+
+  case LED_PHASE_PAUSE:
+  default:
+    phase = LED_PHASE_ON;
+    return LED_HOT_PAUSE_MS;
   }
-  
-  vTaskDelay(pdMS_TO_TICKS(700));
+}
+
+void led_blinky_init()
+{
+  pinMode(LED_GPIO, OUTPUT);
+  runtimeConfigRead(config);
+
+  SensorSnapshot snap;
+  readSensorSnapshot(snap);
+  currentLevel = snap.temp_level;
+
+  // Đổi mức nhiệt / pattern / bật-tắt đều đến qua bus
+  executorAdd("led", TOPIC_MASK(TOPIC_LEVEL_CHANGE) | TOPIC_MASK(TOPIC_CONFIG_CHANGE),
+              ledStep, nullptr);
 }
@@ -0,0 +1,97 @@
+#include "level_tracker.h"
+
+LevelTracker::LevelTracker(uint8_t initial)
+  : _level(initial), _pending(initial), _pendingSince(0)
+{
+  _mux = portMUX_INITIALIZER_UNLOCKED;
+  memset(&_stats, 0, sizeof(_stats));
+  _stats.level = initial;
+}
+
+uint8_t LevelTracker::candidate(centi_t value, centi_t low, centi_t high, centi_t hysteresis,
+                                bool &heldByHysteresis) const
+{
+  // Phân loại thô như trước khi có hysteresis: < thấp, > cao
+  uint8_t raw = LEVEL_MID;
+  if (value < low)
+    raw = LEVEL_LOW;
+  else if (value > high)
+    raw = LEVEL_HIGH;
+
+  // Đang ở mức thấp/cao: chỉ về mức giữa khi đã qua ngưỡng thêm hysteresis
+  uint8_t next = raw;
+  if (raw == LEVEL_MID)
+  {
+    if (_level == LEVEL_LOW && value < low + hysteresis)
+      next = LEVEL_LOW;
+    else if (_level == LEVEL_HIGH && value > high - hysteresis)
+      next = LEVEL_HIGH;
+  }
+
+  heldByHysteresis = (next != raw);
+  return next;
+}
+
+uint8_t LevelTracker::update(centi_t value, centi_t low, centi_t high, centi_t hysteresis,
+                             uint32_t dwellMs, uint32_t nowMs)
+{
+  bool heldByHysteresis = false;
+  uint8_t next = candidate(value, low, high, hysteresis, heldByHysteresis);
+
+  bool heldByDwell = false;
+  bool changed     = false;
+  if (next == _level)
+  {
+    _pending = _level;   // dao động quay về: huỷ mức đang chờ
+  }
+  else
+  {
+    if (next != _pending)
+    {
+      _pending      = next;
+      _pendingSince = nowMs;
+    }
+
+    if (nowMs - _pendingSince >= dwellMs)
+    {
+      _level  = next;
+      changed = true;
+    }
+    else
+      heldByDwell = true;
+  }
+
+  portENTER_CRITICAL(&_mux);
+  if (heldByHysteresis)
+    _stats.held_hyst++;
+  if (heldByDwell)
+    _stats.held_dwell++;
+  if (changed)
+  {
+    _stats.transitions++;
+    _stats.level    = _level;
+    _stats.since_ms = nowMs;
+  }
+  portEXIT_CRITICAL(&_mux);
+
+  return _level;
+}
+
+void LevelTracker::getStats(LevelTrackerStats &out)
+{
+  portENTER_CRITICAL(&_mux);
+  out = _stats;
+  portEXIT_CRITICAL(&_mux);
+}
+
+void LevelTracker::toJson(JsonObject out)
+{
+  LevelTrackerStats st;
+  getStats(st);
+
+  out["level"]       = st.level;
+  out["transitions"] = st.transitions;
+  out["heldHyst"]    = st.held_hyst;
+  out["heldDwell"]   = st.held_dwell;
+  out["inLevelMs"]   = millis() - st.since_ms;
+}
@@ -0,0 +1,318 @@
+#include "logger.h"
+#include "metrics.h"
+
+static_assert((LOG_RING_RECORDS & (LOG_RING_RECORDS - 1)) == 0,
+              "LOG_RING_RECORDS phải là lũy thừa của 2");
+
+// Ring MPSC có giới hạn: producer (mọi task / ISR, cả 2 core) cấp ô bằng CAS
+// trên head, chỉ khi head - tail < LOG_RING_RECORDS; drain task là consumer duy
+// nhất, tăng tail sau khi in xong. Ô đã ghi xong có seq = index + 1.
+static LogRecord             ring[LOG_RING_RECORDS];
+static std::atomic<uint32_t> ringHead(0);
+static std::atomic<uint32_t> ringTail(0);
+
+// Drain task sắp ngủ: producer kế tiếp commit xong thì đánh thức nó.
+// Chỉ tốn một lần notify khi drain đang rảnh, không phải mỗi record.
+static std::atomic<bool> drainWaiting(false);
+static TaskHandle_t      drainTask = nullptr;
+
+static const char *const moduleNames[LOG_MOD_COUNT] = {"sensor", "ml", "mqtt", "web", "bus", "sys"};
+static const char levelChars[] = "-EWID";
+
+// Một dòng in ra, kể cả tiền tố "[time] L module: " và "\n"
+#define LOG_LINE_MAX  192
+
+// ====== Producer ======
+bool logReserve(LogRecord *&rec, uint32_t &index)
+{
+  uint32_t head = ringHead.load(std::memory_order_relaxed);
+  do
+  {
+    if (head - ringTail.load(std::memory_order_acquire) >= LOG_RING_RECORDS)
+    {
+      metricInc(METRIC_LOG_DROPPED);
+      return false;
+    }
+  } while (!ringHead.compare_exchange_weak(head, head + 1, std::memory_order_acq_rel,
+                                           std::memory_order_relaxed));
+
+  index = head;
+  rec   = &ring[head & (LOG_RING_RECORDS - 1)];
+  return true;
+}
+
+void LogWriter::putRaw(uint8_t type, const void *data, uint8_t size)
+{
+  // Đã bỏ một tham số thì bỏ luôn các tham số sau để không lệch thứ tự
+  if (_rec->truncated || _rec->len + 1 + size > LOG_PAYLOAD_BYTES)
+  {
+    _rec->truncated = 1;
+    return;
+  }
+  _rec->payload[_rec->len++] = type;
+  memcpy(_rec->payload + _rec->len, data, size);
+  _rec->len += size;
+}
+
+void LogWriter::putStr(const char *s)
+{
+  if (s == nullptr)
+    s = "(null)";
+
+  uint8_t room = LOG_PAYLOAD_BYTES - _rec->len;
+  if (_rec->truncated || room < 2)
+  {
+    _rec->truncated = 1;
+    return;
+  }
+
+  size_t n = strlen(s);
+  size_t max = room - 2;
+  if (n > max)
+  {
+    n = max;
+    _rec->truncated = 1;   // phần còn lại của record đã dùng hết cho chuỗi này
+  }
+
+  _rec->payload[_rec->len++] = LOG_ARG_STR;
+  _rec->payload[_rec->len++] = (uint8_t)n;
+  memcpy(_rec->payload + _rec->len, s, n);
+  _rec->len += n;
+}
+
+void LogWriter::commit(uint8_t module, uint8_t level, const char *fmt)
+{
+  _rec->fmt    = fmt;
+  _rec->timeMs = millis();
+  _rec->module = module;
+  _rec->level  = level;
+  _rec->seq.store(_index + 1, std::memory_order_release);
+  metricInc(METRIC_LOG_RECORDS);
+
+  // Cặp với fence bên drain: hoặc drain thấy record này, hoặc ta thấy cờ chờ
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (drainWaiting.load(std::memory_order_relaxed) &&
+      drainWaiting.exchange(false, std::memory_order_acq_rel) && drainTask != nullptr)
+  {
+    if (xPortInIsrContext())
+      vTaskNotifyGiveFromISR(drainTask, nullptr);
+    else
+      xTaskNotifyGive(drainTask);
+  }
+}
+
+// ====== Consumer: format theo chuỗi gốc ======
+struct LogArg {
+  uint8_t     type;
+  int64_t     i;
+  double      d;
+  char        s[LOG_PAYLOAD_BYTES];
+};
+
+class LogReader
+{
+public:
+  explicit LogReader(const LogRecord &rec) : _rec(rec), _pos(0) {}
+
+  bool next(LogArg &a)
+  {
+    if (_pos >= _rec.len)
+      return false;
+    a.type = _rec.payload[_pos++];
+    switch (a.type)
+    {
+    case LOG_ARG_I32: { int32_t v;  read(&v, sizeof(v)); a.i = v; a.d = v; break; }
+    case LOG_ARG_U32: { uint32_t v; read(&v, sizeof(v)); a.i = v; a.d = v; break; }
+    case LOG_ARG_I64: { int64_t v;  read(&v, sizeof(v)); a.i = v; a.d = (double)v; break; }
+    case LOG_ARG_DOUBLE: read(&a.d, sizeof(a.d)); a.i = (int64_t)a.d; break;
+    case LOG_ARG_STR:
+    {
+      uint8_t n = _rec.payload[_pos++];
+      read(a.s, n);
+      a.s[n] = '\0';
+      a.i = 0;
+      a.d = 0;
+      return true;
+    }
+    default:
+      return false;
+    }
+    a.s[0] = '\0';
+    return true;
+  }
+
+private:
+  void read(void *out, uint8_t size)
+  {
+    memcpy(out, _rec.payload + _pos, size);
+    _pos += size;
+  }
+
+  const LogRecord &_rec;
+  uint8_t          _pos;
+};
+
+// Format một tham số bằng đúng spec gốc (%5.2f, %lu, %-8s ...), ép giá trị
+// về kiểu mà conversion đó chờ
+static int formatArg(char *out, size_t size, const char *spec, char conv, const LogArg &a)
+{
+  bool longLong = strstr(spec, "ll") != nullptr;
+  bool isLong   = !longLong && strchr(spec, 'l') != nullptr;
+
+  switch (conv)
+  {
+  case 'd': case 'i':
+    if (longLong) return snprintf(out, size, spec, (long long)a.i);
+    if (isLong)   return snprintf(out, size, spec, (long)a.i);
+    return snprintf(out, size, spec, (int)a.i);
+  case 'u': case 'x': case 'X': case 'o':
+    if (longLong) return snprintf(out, size, spec, (unsigned long long)a.i);
+    if (isLong)   return snprintf(out, size, spec, (unsigned long)a.i);
+    return snprintf(out, size, spec, (unsigned)a.i);
+  case 'c':
+    return snprintf(out, size, spec, (int)a.i);
+  case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+    return snprintf(out, size, spec, a.d);
+  case 's':
+    return snprintf(out, size, spec, a.type == LOG_ARG_STR ? a.s : "?");
+  case 'p':
+    return snprintf(out, size, spec, (void *)(uintptr_t)a.i);
+  default:
+    return snprintf(out, size, "<%%%c?>", conv);
+  }
+}
+
+static size_t formatRecord(char *out, size_t size, const LogRecord &rec)
+{
+  LogReader reader(rec);
+  LogArg arg;
+  char spec[16];
+  size_t pos = 0;
+  const char *p = rec.fmt;
+
+  while (*p != '\0' && pos + 1 < size)
+  {
+    if (*p != '%')
+    {
+      out[pos++] = *p++;
+      continue;
+    }
+    if (p[1] == '%')
+    {
+      out[pos++] = '%';
+      p += 2;
+      continue;
+    }
+
+    // Spec = '%' + flags / width / precision / length + conversion
+    const char *start = p++;
+    while (*p != '\0' && strchr("-+ #0123456789.hlLzjt", *p) != nullptr)
+      p++;
+    if (*p == '\0')
+      break;
+    char conv = *p++;
+
+    size_t specLen = p - start;
+    if (specLen >= sizeof(spec) || !reader.next(arg))
+    {
+      int n = snprintf(out + pos, size - pos, "<?>");
+      pos += (n > 0) ? n : 0;
+      if (pos >= size)
+        pos = size - 1;
+      continue;
+    }
+    memcpy(spec, start, specLen);
+    spec[specLen] = '\0';
+
+    int n = formatArg(out + pos, size - pos, spec, conv, arg);
+    if (n > 0)
+      pos += n;
+    if (pos >= size)
+      pos = size - 1;
+  }
+
+  if (rec.truncated && pos + 4 < size)
+  {
+    memcpy(out + pos, "...", 3);
+    pos += 3;
+  }
+  out[pos] = '\0';
+  return pos;
+}
+
+static void printRecord(const LogRecord &rec)
+{
+  char line[LOG_LINE_MAX];
+  int n = snprintf(line, sizeof(line), "[%6lu.%03lu] %c %s: ",
+                   (unsigned long)(rec.timeMs / 1000), (unsigned long)(rec.timeMs % 1000),
+                   levelChars[rec.level < sizeof(levelChars) - 1 ? rec.level : 0],
+                   rec.module < LOG_MOD_COUNT ? moduleNames[rec.module] : "?");
+  if (n < 0)
+    return;
+
+  size_t len = n + formatRecord(line + n, sizeof(line) - n - 1, rec);
+  line[len++] = '\n';
+  Serial.write((const uint8_t *)line, len);
+}
+
+// In mọi record đã ghi xong theo thứ tự; dừng ở ô producer còn đang ghi dở
+static void drainRing()
+{
+  uint32_t tail = ringTail.load(std::memory_order_relaxed);
+  while (tail != ringHead.load(std::memory_order_acquire))
+  {
+    LogRecord &rec = ring[tail & (LOG_RING_RECORDS - 1)];
+    if (rec.seq.load(std::memory_order_acquire) != tail + 1)
+      break;
+    printRecord(rec);
+    ringTail.store(++tail, std::memory_order_release);
+  }
+}
+
+static bool ringHasCommitted()
+{
+  uint32_t tail = ringTail.load(std::memory_order_relaxed);
+  return tail != ringHead.load(std::memory_order_acquire) &&
+         ring[tail & (LOG_RING_RECORDS - 1)].seq.load(std::memory_order_acquire) == tail + 1;
+}
+
+void log_drain_task(void *pvParameters)
+{
+  drainTask = xTaskGetCurrentTaskHandle();
+  uint32_t reportedDrops = 0;
+
+  for (;;)
+  {
+    drainRing();
+
+    // Báo số record bị bỏ kể từ lần báo trước, ngay trong luồng log
+    uint32_t drops = metricCounters[METRIC_LOG_DROPPED].load(std::memory_order_relaxed);
+    if (drops != reportedDrops)
+    {
+      Serial.printf("[log] %lu record bị bỏ (ring đầy)\n", (unsigned long)(drops - reportedDrops));
+      reportedDrops = drops;
+    }
+
+    // Đặt cờ rồi kiểm tra lại: record commit giữa hai bước vẫn đánh thức được
+    drainWaiting.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (ringHasCommitted())
+    {
+      drainWaiting.store(false, std::memory_order_relaxed);
+      continue;
+    }
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+  }
+}
+
+void logFlush(uint32_t timeoutMs)
+{
+  uint32_t start = millis();
+  while (drainTask != nullptr &&
+         ringTail.load(std::memory_order_acquire) != ringHead.load(std::memory_order_acquire) &&
+         millis() - start < timeoutMs)
+  {
+    vTaskDelay(pdMS_TO_TICKS(10));
+  }
+  Serial.flush();
+}
@@ -1,10 +1,13 @@
 #include "global.h"
 
+#include "event_bus.h"
+#include "runtime_config.h"
+#include "telemetry_encoder.h"
+#include "task_table.h"
+#include "timer_wheel.h"
+#include "supervisor.h"
 #include "led_blinky.h"
 #include "neo_blinky.h"
-#include "temp_humi_monitor.h"
-#include "tinyml.h"
-#include "coreiot.h"
 
 // include task
 #include "task_check_info.h"
@@ -18,76 +21,34 @@ void setup()
 {
   Serial.begin(115200);
 
+  // Cấu hình runtime mặc định, trước mọi task / job đọc nó
+  runtimeConfigBegin();
+
   // Lần đầu: load thông tin WiFi/CoreIoT từ LittleFS.
   // Nếu chưa có, check_info_File(false) sẽ start AP để cấu hình.
   check_info_File(false);
 
-  // Task 1: LED theo nhiệt độ
-  xTaskCreate(led_blinky,
-              "Task LED Blink",
-              2048,
-              nullptr,
-              2,
-              nullptr);
-
-  // Task 2: NeoPixel theo độ ẩm
-  xTaskCreate(neo_blinky,
-              "Task NEO Blink",
-              2048,
-              nullptr,
-              2,
-              nullptr);
+  // Event bus phải sẵn sàng trước khi các task đăng ký / phát sự kiện
+  eventBusBegin();
+  telemetryEncoderBegin();
+  Webserver_subscribeEvents();
 
-  // Task 3: Đọc DHT20 + LCD + phát semaphore + gửi WebSocket
-  xTaskCreate(temp_humi_monitor,
-              "Task TEMP HUMI Monitor",
-              4096,
-              nullptr,
-              3,   // ưu tiên nhỉnh hơn vì feed dữ liệu cho các task khác
-              nullptr);
+  // Deadline của mọi job executor nằm trên timer wheel
+  timerWheelBegin();
+  supervisorBegin();
 
-  // // Task 4: WebServer + AP + STA mode
-  // xTaskCreate(
-  //     main_server_task,
-  //     "Main WebServer Task",
-  //     8192,
-  //     nullptr,
-  //     4,
-  //     nullptr
-  // );
-  // Task 5: TinyML chạy mô hình & đánh giá accuracy
-  xTaskCreate(tiny_ml_task,
-              "Tiny ML Task",
-              8192,
-              nullptr,
-              2,
-              nullptr);
+  // Job nhẹ chạy chung task executor, phải đăng ký trước khi executor chạy
+  led_blinky_init();
+  neo_blinky_init();
+  Task_Toogle_BOOT_init();
+  Wifi_init();
 
-  // CoreIoT MQTT client
-  xTaskCreate(coreiot_task,
-              "CoreIOT Task",
-              4096,
-              nullptr,
-              2,
-              nullptr);
-
-  // Nút BOOT giữ lâu để xoá config WiFi
-  xTaskCreate(Task_Toogle_BOOT,
-              "Task_Toogle_BOOT",
-              2048,
-              nullptr,
-              1,
-              nullptr);
+  // Mọi task được tạo theo bảng phân core / ưu tiên trong task_table.cpp
+  startTaskTable();
 }
 
 void loop()
 {
-  // Nếu đã có cấu hình WiFi => thử reconnect ở chế độ STA
-  if (check_info_File(true))
-  {
-    Wifi_reconnect(); 
-  }
-
-  // Đảm bảo WebServer (AP/WebSocket) luôn chạy
-  Webserver_reconnect();
+  // Ngủ tới khi có sự kiện WiFi / WebServer dừng / OTA xong, không còn quay 100% CPU
+  supervisorRun();
 }
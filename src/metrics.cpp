@@ -0,0 +1,72 @@
+#include "metrics.h"
+#include "task_table.h"
+#include "event_bus.h"
+#include "executor.h"
+#include "latency.h"
+#include "heap_stats.h"
+
+std::atomic<uint32_t> metricCounters[METRIC_COUNT];
+
+static const char *const metricNames[METRIC_COUNT] = {
+  "samples", "sampleErrors", "inferences",
+  "mqttPublishes", "mqttFailures", "mqttRpc", "wsFrames",
+  "logRecords", "logDropped"
+};
+
+static void heapToJson(JsonObject out)
+{
+  uint32_t freeHeap = ESP.getFreeHeap();
+  uint32_t maxBlock = ESP.getMaxAllocHeap();
+
+  out["heapFree"]     = freeHeap;
+  out["heapMaxBlock"] = maxBlock;
+  out["heapMinFree"]  = ESP.getMinFreeHeap();
+  // Phân mảnh: phần heap trống không cấp được trong một khối liền
+  out["heapFrag"]     = freeHeap ? 100 - (uint32_t)((uint64_t)maxBlock * 100 / freeHeap) : 0;
+}
+
+static void countersToJson(JsonObject out)
+{
+  for (uint8_t i = 0; i < METRIC_COUNT; ++i)
+    out[metricNames[i]] = metricCounters[i].load(std::memory_order_relaxed);
+}
+
+void metricsToJson(JsonObject out)
+{
+  out["uptimeMs"] = millis();
+  heapToJson(out.createNestedObject("heap"));
+  countersToJson(out.createNestedObject("counters"));
+  latencyToJson(out.createNestedObject("latency"));
+#ifdef HEAP_STATS
+  heapStatsToJson(out.createNestedObject("alloc"));
+#endif
+
+  EventBusStats bus;
+  eventBusGetStats(bus);
+  JsonObject b = out.createNestedObject("bus");
+  b["published"]  = bus.published;
+  b["delivered"]  = bus.delivered;
+  b["coalesced"]  = bus.coalesced;
+  b["overflowed"] = bus.overflowed;
+  b["poolEmpty"]  = bus.pool_empty;
+
+  // Cửa sổ tải core riêng cho /metrics (dashboard hỏi định kỳ)
+  static TaskLoadWindow window = {};
+  taskLoadToJson(out, window);
+  taskStackToJson(out.createNestedArray("stacks"));
+  executorStatsToJson(out.createNestedArray("jobs"));
+}
+
+void metricsSummaryToJson(JsonObject out)
+{
+  out["uptimeMs"] = millis();
+  heapToJson(out);
+  countersToJson(out);
+  latencySummaryToJson(out);
+#ifdef HEAP_STATS
+  heapStatsSummaryToJson(out);
+#endif
+
+  static TaskLoadWindow window = {};
+  taskLoadToJson(out, window, false);
+}
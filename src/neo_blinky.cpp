@@ -1,35 +1,28 @@
 #include "neo_blinky.h"
 #include "global.h"
+#include "fixed_point.h"
+#include "executor.h"
+#include "runtime_config.h"
 
 static Adafruit_NeoPixel strip(LED_COUNT, NEO_PIN, NEO_GRB + NEO_KHZ800);
 
-static void applyHumiColor(uint8_t level, float humi);
+#ifdef SENSOR_FIXED_POINT
+// Độ ẩm giữ ở 0.01 %RH, map độ sáng bằng số nguyên
+typedef centi_t humi_t;
+#define HUMI_VALUE(snap)      ((centi_t)(snap).humi_centi)
+#define HUMI_THRESHOLD(v)     centiFromFloat(v)
+#define HUMI_FULL_SCALE       (100 * CENTI_SCALE)
 
-void neo_blinky(void *pvParameters)
+static inline uint8_t mapBrightness(centi_t x, centi_t in_min, centi_t in_max,
+                                    uint8_t out_min, uint8_t out_max)
 {
-  strip.begin();
-  strip.clear();
-  strip.show();
-
-  applyHumiColor(glob_humi_level, glob_humidity);
-
-  while (1)
-  {
-    // Người dùng tắt NeoPixel từ web => luôn tắt
-    if (!glob_humi_led_enabled)
-    {
-      strip.clear();
-      strip.show();
-      vTaskDelay(pdMS_TO_TICKS(100));
-      continue;
-    }
-
-    if (xHumiNeoSemaphore != nullptr && xSemaphoreTake(xHumiNeoSemaphore, portMAX_DELAY) == pdTRUE)
-    {
-      applyHumiColor(glob_humi_level, glob_humidity);
-    }
-  }
+  return mapBrightnessCenti(x, in_min, in_max, out_min, out_max);
 }
+#else
+typedef float humi_t;
+#define HUMI_VALUE(snap)      ((snap).humidity)
+#define HUMI_THRESHOLD(v)     (v)
+#define HUMI_FULL_SCALE       100.0f
 
 static uint8_t mapBrightness(float x, float in_min, float in_max, uint8_t out_min, uint8_t out_max)
 {
@@ -49,42 +42,48 @@ static uint8_t mapBrightness(float x, float in_min, float in_max, uint8_t out_mi
 
   return (uint8_t)val;
 }
+#endif
 
-static void applyHumiColor(uint8_t level, float humi)
+static void applyHumiColor(const SensorSnapshot &snap, const RuntimeConfig &rc)
 {
   uint8_t r = 0, g = 0, b = 0;
   uint8_t brightness = 150;
 
-  const float HUMI_MIN = 0.0f;
-  const float HUMI_MAX = 100.0f;
+  uint8_t level      = snap.humi_level;
+  humi_t  humi       = HUMI_VALUE(snap);
+  humi_t  dryLimit   = HUMI_THRESHOLD(rc.humiDry);
+  humi_t  humidLimit = HUMI_THRESHOLD(rc.humiHumid);
+
+  const humi_t HUMI_MIN = 0;
+  const humi_t HUMI_MAX = HUMI_FULL_SCALE;
 
   switch (level)
   {
   case HUMI_LEVEL_DRY:
-    r = neoColorConfig[HUMI_LEVEL_DRY].r;
-    g = neoColorConfig[HUMI_LEVEL_DRY].g;
-    b = neoColorConfig[HUMI_LEVEL_DRY].b;
-    brightness = mapBrightness(humi, HUMI_MIN, humiDryThreshold, 255, 80);
+    r = rc.neoColor[HUMI_LEVEL_DRY].r;
+    g = rc.neoColor[HUMI_LEVEL_DRY].g;
+    b = rc.neoColor[HUMI_LEVEL_DRY].b;
+    brightness = mapBrightness(humi, HUMI_MIN, dryLimit, 255, 80);
     break;
 
   case HUMI_LEVEL_OK:
-    r = neoColorConfig[HUMI_LEVEL_OK].r;
-    g = neoColorConfig[HUMI_LEVEL_OK].g;
-    b = neoColorConfig[HUMI_LEVEL_OK].b;
-    brightness = mapBrightness(humi, humiDryThreshold, humiHumidThreshold, 80, 200);
+    r = rc.neoColor[HUMI_LEVEL_OK].r;
+    g = rc.neoColor[HUMI_LEVEL_OK].g;
+    b = rc.neoColor[HUMI_LEVEL_OK].b;
+    brightness = mapBrightness(humi, dryLimit, humidLimit, 80, 200);
     break;
 
   case HUMI_LEVEL_HUMID:
-    r = neoColorConfig[HUMI_LEVEL_HUMID].r;
-    g = neoColorConfig[HUMI_LEVEL_HUMID].g;
-    b = neoColorConfig[HUMI_LEVEL_HUMID].b;
-    brightness = mapBrightness(humi, humiHumidThreshold, HUMI_MAX, 80, 255);
+    r = rc.neoColor[HUMI_LEVEL_HUMID].r;
+    g = rc.neoColor[HUMI_LEVEL_HUMID].g;
+    b = rc.neoColor[HUMI_LEVEL_HUMID].b;
+    brightness = mapBrightness(humi, humidLimit, HUMI_MAX, 80, 255);
     break;
 
   default:
-    r = neoColorConfig[HUMI_LEVEL_OK].r;
-    g = neoColorConfig[HUMI_LEVEL_OK].g;
-    b = neoColorConfig[HUMI_LEVEL_OK].b;
+    r = rc.neoColor[HUMI_LEVEL_OK].r;
+    g = rc.neoColor[HUMI_LEVEL_OK].g;
+    b = rc.neoColor[HUMI_LEVEL_OK].b;
     brightness = 150;
     break;
   }
@@ -94,3 +93,48 @@ static void applyHumiColor(uint8_t level, float humi)
   strip.setPixelColor(0, color);
   strip.show();
 }
+
+// Chỉ vẽ lại khi mức ẩm, màu, ngưỡng hoặc trạng thái bật/tắt thay đổi
+static uint32_t neoStep(const EventMsg *msg, void *ctx)
+{
+  if (msg != nullptr)
+  {
+    bool redraw = false;
+    if (msg->topic == TOPIC_LEVEL_CHANGE)
+      redraw = (msg->as<LevelChangeEvent>().changed & LEVEL_CHANGED_HUMI) != 0;
+    else if (msg->topic == TOPIC_CONFIG_CHANGE)
+    {
+      uint8_t section = msg->as<ConfigChangeEvent>().section;
+      redraw = (section == CONFIG_NEO_COLOR || section == CONFIG_DEVICE_ENABLE ||
+                section == CONFIG_THRESHOLDS);
+    }
+    if (!redraw)
+      return EXEC_WAIT_EVENT;
+  }
+
+  RuntimeConfig rc;
+  runtimeConfigRead(rc);
+
+  // Người dùng tắt NeoPixel từ web => luôn tắt
+  if (!rc.humiLedEnabled)
+  {
+    strip.clear();
+    strip.show();
+    return EXEC_WAIT_EVENT;
+  }
+
+  SensorSnapshot snap;
+  readSensorSnapshot(snap);
+  applyHumiColor(snap, rc);
+  return EXEC_WAIT_EVENT;
+}
+
+void neo_blinky_init()
+{
+  strip.begin();
+  strip.clear();
+  strip.show();
+
+  executorAdd("neo", TOPIC_MASK(TOPIC_LEVEL_CHANGE) | TOPIC_MASK(TOPIC_CONFIG_CHANGE),
+              neoStep, nullptr);
+}
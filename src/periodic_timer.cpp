@@ -0,0 +1,84 @@
+#include "periodic_timer.h"
+#include "esp_timer.h"
+
+PeriodicTimer *PeriodicTimer::_first = nullptr;
+static portMUX_TYPE periodicListMux = portMUX_INITIALIZER_UNLOCKED;
+
+PeriodicTimer::PeriodicTimer(const char *name, uint32_t periodMs)
+  : _name(name),
+    _periodMs(periodMs),
+    _lastWake(xTaskGetTickCount()),
+    _lastWakeUs(esp_timer_get_time()),
+    _cycles(0),
+    _missed(0),
+    _maxJitterUs(0)
+{
+  memset(_hist, 0, sizeof(_hist));
+
+  portENTER_CRITICAL(&periodicListMux);
+  _next  = _first;
+  _first = this;
+  portEXIT_CRITICAL(&periodicListMux);
+}
+
+bool PeriodicTimer::wait()
+{
+  BaseType_t onTime = xTaskDelayUntil(&_lastWake, pdMS_TO_TICKS(_periodMs));
+  int64_t now = esp_timer_get_time();
+
+  if (onTime != pdTRUE)
+  {
+    // Lỡ deadline: không chạy bù dồn dập, tính lịch mới từ thời điểm hiện tại
+    _missed++;
+    _lastWake = xTaskGetTickCount();
+  }
+  else
+  {
+    int64_t interval = now - _lastWakeUs;
+    int64_t jitter   = interval - (int64_t)_periodMs * 1000;
+    if (jitter < 0) jitter = -jitter;
+    record((uint32_t)jitter);
+  }
+
+  _lastWakeUs = now;
+  _cycles++;
+  return onTime == pdTRUE;
+}
+
+void PeriodicTimer::setPeriod(uint32_t periodMs)
+{
+  _periodMs = periodMs;
+}
+
+void PeriodicTimer::record(uint32_t jitterUs)
+{
+  if (jitterUs > _maxJitterUs)
+    _maxJitterUs = jitterUs;
+
+  uint8_t bucket = 0;
+  uint32_t limit = PERIODIC_HIST_BASE_US;
+  while (bucket < PERIODIC_HIST_BUCKETS - 1 && jitterUs >= limit)
+  {
+    bucket++;
+    limit <<= 1;
+  }
+  _hist[bucket]++;
+}
+
+void PeriodicTimer::statsToJson(JsonArray out)
+{
+  // Danh sách chỉ được thêm vào đầu, duyệt từ _first là an toàn
+  for (PeriodicTimer *t = _first; t != nullptr; t = t->_next)
+  {
+    JsonObject o = out.createNestedObject();
+    o["name"]      = t->_name;
+    o["period"]    = t->_periodMs;
+    o["cycles"]    = t->_cycles;
+    o["missed"]    = t->_missed;
+    o["jitterMax"] = t->_maxJitterUs;
+
+    JsonArray hist = o.createNestedArray("hist");
+    for (uint8_t i = 0; i < PERIODIC_HIST_BUCKETS; ++i)
+      hist.add(t->_hist[i]);
+  }
+}
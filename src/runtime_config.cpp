@@ -0,0 +1,106 @@
+#include "runtime_config.h"
+#include <atomic>
+
+// 3 buffer: bản hiện tại, bản nháp của writer, và một bản cho reader bị
+// preempt đang chép dở. Mỗi buffer có version riêng làm seqlock: writer đặt 0
+// trước khi ghi, reader chép xong thấy version đổi thì đọc lại.
+#define RUNTIME_CONFIG_SLOTS  3
+
+struct ConfigSlot {
+  std::atomic<uint32_t> version;   // 0 = đang được writer ghi
+  RuntimeConfig         cfg;
+};
+
+static ConfigSlot                 slots[RUNTIME_CONFIG_SLOTS];
+static std::atomic<ConfigSlot *>  currentSlot(nullptr);
+static ConfigSlot                *draftSlot = nullptr;
+static uint32_t                   lastVersion = 0;
+
+static StaticSemaphore_t writerMutexBuffer;
+static SemaphoreHandle_t writerMutex = nullptr;
+
+void runtimeConfigBegin()
+{
+  if (writerMutex != nullptr)
+    return;
+  writerMutex = xSemaphoreCreateMutexStatic(&writerMutexBuffer);
+
+  RuntimeConfig &cfg = slots[0].cfg;
+  cfg.version   = ++lastVersion;
+  cfg.tempCold  = TEMP_COLD_THRESHOLD;
+  cfg.tempHot   = TEMP_HOT_THRESHOLD;
+  cfg.humiDry   = HUMI_DRY_THRESHOLD;
+  cfg.humiHumid = HUMI_HUMID_THRESHOLD;
+
+  cfg.tempHysteresis = LEVEL_TEMP_HYSTERESIS;
+  cfg.humiHysteresis = LEVEL_HUMI_HYSTERESIS;
+  cfg.levelDwellMs   = LEVEL_DWELL_MS;
+
+  // Nháy LED theo nhiệt độ (ms)
+  cfg.tempLed[TEMP_LEVEL_COLD]   = {1000, 1000};
+  cfg.tempLed[TEMP_LEVEL_NORMAL] = {200, 800};
+  cfg.tempLed[TEMP_LEVEL_HOT]    = {150, 150};
+
+  // Màu NeoPixel theo độ ẩm
+  cfg.neoColor[HUMI_LEVEL_DRY]   = {0, 0, 255};   // xanh dương
+  cfg.neoColor[HUMI_LEVEL_OK]    = {0, 255, 0};   // xanh lá
+  cfg.neoColor[HUMI_LEVEL_HUMID] = {255, 0, 0};   // đỏ
+
+  cfg.tempLedEnabled = true;
+  cfg.humiLedEnabled = true;
+
+  slots[0].version.store(cfg.version, std::memory_order_relaxed);
+  currentSlot.store(&slots[0], std::memory_order_release);
+}
+
+bool runtimeConfigRead(RuntimeConfig &out, uint32_t lastSeen)
+{
+  for (;;)
+  {
+    ConfigSlot *slot = currentSlot.load(std::memory_order_acquire);
+    uint32_t version = slot->version.load(std::memory_order_acquire);
+    if (version == 0)
+      continue;   // writer đã vòng lại đúng buffer này: lấy con trỏ mới
+    if (version == lastSeen)
+      return false;
+
+    out = slot->cfg;
+    std::atomic_thread_fence(std::memory_order_acquire);
+
+    if (slot->version.load(std::memory_order_relaxed) == version)
+      return true;
+  }
+}
+
+uint32_t runtimeConfigVersion()
+{
+  ConfigSlot *slot = currentSlot.load(std::memory_order_acquire);
+  return slot->version.load(std::memory_order_acquire);
+}
+
+RuntimeConfig &runtimeConfigEdit()
+{
+  xSemaphoreTake(writerMutex, portMAX_DELAY);
+
+  ConfigSlot *current = currentSlot.load(std::memory_order_relaxed);
+  draftSlot = &slots[((current - slots) + 1) % RUNTIME_CONFIG_SLOTS];
+
+  // Báo reader còn giữ con trỏ cũ tới buffer này rằng nó sắp bị ghi đè
+  draftSlot->version.store(0, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  draftSlot->cfg = current->cfg;
+  return draftSlot->cfg;
+}
+
+uint32_t runtimeConfigCommit()
+{
+  uint32_t version = ++lastVersion;
+  draftSlot->cfg.version = version;
+  draftSlot->version.store(version, std::memory_order_release);
+  currentSlot.store(draftSlot, std::memory_order_release);
+  draftSlot = nullptr;
+
+  xSemaphoreGive(writerMutex);
+  return version;
+}
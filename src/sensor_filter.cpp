@@ -0,0 +1,206 @@
+#include "sensor_filter.h"
+
+static SensorFilterConfig filterConfig = {SENSOR_FILTER_MEDIAN, 3, SENSOR_FILTER_MIN_SPACING_MS,
+                                          0.3f, 0.01f, 0.25f, (int32_t)(0.3f * 65536)};
+static uint32_t           filterGeneration = 1;
+static portMUX_TYPE       filterConfigMux = portMUX_INITIALIZER_UNLOCKED;
+
+static const char *const filterModeNames[] = {"none", "median", "ewma", "kalman"};
+
+static inline float midpoint(float a, float b)      { return (a + b) * 0.5f; }
+static inline centi_t midpoint(centi_t a, centi_t b) { return (a + b) / 2; }
+
+template <typename T>
+static T medianOf(const T *samples, uint8_t n)
+{
+  // Sắp xếp chèn trên bản sao: n <= 9 nên rẻ hơn mọi thuật toán khác
+  T sorted[SENSOR_FILTER_MAX_OVERSAMPLE];
+  for (uint8_t i = 0; i < n; ++i)
+  {
+    T v = samples[i];
+    uint8_t j = i;
+    while (j > 0 && sorted[j - 1] > v)
+    {
+      sorted[j] = sorted[j - 1];
+      j--;
+    }
+    sorted[j] = v;
+  }
+
+  if (n & 1)
+    return sorted[n / 2];
+  return midpoint(sorted[n / 2 - 1], sorted[n / 2]);
+}
+
+// ====== SensorFilter ======
+SensorFilter::SensorFilter()
+{
+  reset();
+}
+
+void SensorFilter::reset()
+{
+  _primed     = false;
+  _estimate   = 0.0f;
+  _variance   = 0.0f;
+  _estimateQ8 = 0;
+}
+
+float SensorFilter::update(const float *samples, uint8_t n, const SensorFilterConfig &cfg)
+{
+  if (n == 0)
+    return _estimate;
+  if (n > SENSOR_FILTER_MAX_OVERSAMPLE)
+    n = SENSOR_FILTER_MAX_OVERSAMPLE;
+
+  switch (cfg.mode)
+  {
+  case SENSOR_FILTER_MEDIAN:
+    _estimate = medianOf(samples, n);
+    break;
+
+  case SENSOR_FILTER_EWMA:
+    for (uint8_t i = 0; i < n; ++i)
+    {
+      if (!_primed)
+      {
+        _estimate = samples[i];
+        _primed   = true;
+      }
+      else
+        _estimate += cfg.ewma_alpha * (samples[i] - _estimate);
+    }
+    break;
+
+  case SENSOR_FILTER_KALMAN:
+    for (uint8_t i = 0; i < n; ++i)
+    {
+      if (!_primed)
+      {
+        _estimate = samples[i];
+        _variance = cfg.kalman_r;
+        _primed   = true;
+        continue;
+      }
+      // Dự đoán: giá trị giữ nguyên, độ bất định tăng thêm Q
+      _variance += cfg.kalman_q;
+      // Cập nhật theo mẫu đo
+      float gain = _variance / (_variance + cfg.kalman_r);
+      _estimate += gain * (samples[i] - _estimate);
+      _variance *= (1.0f - gain);
+    }
+    break;
+
+  default:
+  {
+    float sum = 0.0f;
+    for (uint8_t i = 0; i < n; ++i)
+      sum += samples[i];
+    _estimate = sum / n;
+    break;
+  }
+  }
+
+  return _estimate;
+}
+
+centi_t SensorFilter::update(const centi_t *samples, uint8_t n, const SensorFilterConfig &cfg)
+{
+  if (n == 0)
+    return (_estimateQ8 + 0x80) >> 8;
+  if (n > SENSOR_FILTER_MAX_OVERSAMPLE)
+    n = SENSOR_FILTER_MAX_OVERSAMPLE;
+
+  switch (cfg.mode)
+  {
+  case SENSOR_FILTER_MEDIAN:
+    _estimateQ8 = medianOf(samples, n) * 256;
+    break;
+
+  case SENSOR_FILTER_EWMA:
+    for (uint8_t i = 0; i < n; ++i)
+    {
+      int32_t x = samples[i] * 256;
+      if (!_primed)
+      {
+        _estimateQ8 = x;
+        _primed     = true;
+      }
+      else
+        _estimateQ8 += (int32_t)(((int64_t)cfg.ewma_alpha_q16 * (x - _estimateQ8)) >> 16);
+    }
+    break;
+
+  case SENSOR_FILTER_KALMAN:
+  {
+    float buf[SENSOR_FILTER_MAX_OVERSAMPLE];
+    for (uint8_t i = 0; i < n; ++i)
+      buf[i] = centiToFloat(samples[i]);
+    _estimateQ8 = centiFromFloat(update(buf, n, cfg)) * 256;
+    break;
+  }
+
+  default:
+  {
+    int32_t sum = 0;
+    for (uint8_t i = 0; i < n; ++i)
+      sum += samples[i];
+    // Chia có làm tròn, đúng cả với giá trị âm
+    _estimateQ8 = ((sum >= 0 ? sum + n / 2 : sum - n / 2) / n) * 256;
+    break;
+  }
+  }
+
+  // Làm tròn Q8 → centi (dịch phải số học trên ESP32/GCC)
+  return (_estimateQ8 + 0x80) >> 8;
+}
+
+// ====== Cấu hình runtime ======
+void sensorFilterSetConfig(const SensorFilterConfig &cfg)
+{
+  SensorFilterConfig c = cfg;
+  if (c.mode > SENSOR_FILTER_KALMAN) c.mode = SENSOR_FILTER_NONE;
+  if (c.oversample < 1) c.oversample = 1;
+  if (c.oversample > SENSOR_FILTER_MAX_OVERSAMPLE) c.oversample = SENSOR_FILTER_MAX_OVERSAMPLE;
+  if (c.spacing_ms < SENSOR_FILTER_MIN_SPACING_MS) c.spacing_ms = SENSOR_FILTER_MIN_SPACING_MS;
+  if (c.spacing_ms > SENSOR_FILTER_MAX_SPACING_MS) c.spacing_ms = SENSOR_FILTER_MAX_SPACING_MS;
+  if (!(c.ewma_alpha > 0.0f)) c.ewma_alpha = 0.01f;
+  if (c.ewma_alpha > 1.0f)    c.ewma_alpha = 1.0f;
+  if (!(c.kalman_q > 0.0f))   c.kalman_q = 0.0001f;
+  if (!(c.kalman_r > 0.0f))   c.kalman_r = 0.0001f;
+  c.ewma_alpha_q16 = (int32_t)(c.ewma_alpha * 65536 + 0.5f);
+
+  portENTER_CRITICAL(&filterConfigMux);
+  filterConfig = c;
+  filterGeneration++;
+  portEXIT_CRITICAL(&filterConfigMux);
+}
+
+bool sensorFilterGetConfig(SensorFilterConfig &out, uint32_t &generation)
+{
+  portENTER_CRITICAL(&filterConfigMux);
+  out = filterConfig;
+  uint32_t current = filterGeneration;
+  portEXIT_CRITICAL(&filterConfigMux);
+
+  bool changed = (current != generation);
+  generation = current;
+  return changed;
+}
+
+const char *sensorFilterModeName(uint8_t mode)
+{
+  if (mode > SENSOR_FILTER_KALMAN)
+    mode = SENSOR_FILTER_NONE;
+  return filterModeNames[mode];
+}
+
+uint8_t sensorFilterModeFromName(const String &name, uint8_t fallback)
+{
+  for (uint8_t i = 0; i <= SENSOR_FILTER_KALMAN; ++i)
+  {
+    if (name == filterModeNames[i])
+      return i;
+  }
+  return fallback;
+}
@@ -0,0 +1,121 @@
+#include "sensor_history.h"
+
+SensorHistory sensorHistory;
+
+// ====== Iterator ======
+SensorHistory::Iterator::Iterator(const SensorHistory *history, uint32_t index, uint32_t end)
+  : _history(history), _index(index), _end(end)
+{
+  load();
+}
+
+SensorHistory::Iterator &SensorHistory::Iterator::operator++()
+{
+  _index++;
+  load();
+  return *this;
+}
+
+void SensorHistory::Iterator::load()
+{
+  while (_index < _end)
+  {
+    if (_history->read(_index, _sample))
+      return;
+
+    // Slot đã bị writer ghi đè trong lúc duyệt: nhảy tới mẫu cũ nhất còn hợp lệ
+    uint32_t oldest = _history->oldestIndex(_history->head());
+    _index = (oldest > _index) ? oldest : _index + 1;
+  }
+  _index = _end;
+}
+
+// ====== SensorHistory ======
+SensorHistory::SensorHistory() : _head(0)
+{
+}
+
+void SensorHistory::push(uint32_t timestampMs, float temperature, float humidity)
+{
+  pushCenti(timestampMs,
+            centiFromFloat(constrain(temperature, -320.0f, 320.0f)),
+            centiFromFloat(constrain(humidity, 0.0f, 100.0f)));
+}
+
+void SensorHistory::pushCenti(uint32_t timestampMs, centi_t temperature, centi_t humidity)
+{
+  uint32_t index = _head.load(std::memory_order_relaxed);
+  uint32_t slot  = index % SENSOR_HISTORY_CAPACITY;
+
+  _timestamp[slot] = timestampMs;
+  _temp[slot]      = (int16_t)constrain(temperature, -32000, 32000);
+  _humi[slot]      = (uint16_t)constrain(humidity, 0, 10000);
+
+  // Release: reader thấy head mới thì cũng thấy dữ liệu slot đã ghi xong
+  _head.store(index + 1, std::memory_order_release);
+}
+
+uint32_t SensorHistory::oldestIndex(uint32_t head) const
+{
+  // Chừa 1 slot vì writer có thể đang ghi đè slot của mẫu cũ nhất
+  return (head >= SENSOR_HISTORY_CAPACITY) ? head - SENSOR_HISTORY_CAPACITY + 1 : 0;
+}
+
+uint32_t SensorHistory::size() const
+{
+  uint32_t h = head();
+  return h - oldestIndex(h);
+}
+
+bool SensorHistory::read(uint32_t index, HistorySample &out) const
+{
+  uint32_t h = head();
+  if (index >= h || index < oldestIndex(h))
+    return false;
+
+  uint32_t slot    = index % SENSOR_HISTORY_CAPACITY;
+  out.timestamp_ms = _timestamp[slot];
+  out.temp_centi   = _temp[slot];
+  out.humi_centi   = _humi[slot];
+
+  // Đọc lại head: nếu writer đã vòng qua slot này thì dữ liệu không còn tin được
+  std::atomic_thread_fence(std::memory_order_acquire);
+  return index >= oldestIndex(head());
+}
+
+SensorHistory::Range SensorHistory::latest(uint32_t n) const
+{
+  uint32_t h      = head();
+  uint32_t oldest = oldestIndex(h);
+  uint32_t first  = (h - oldest > n) ? h - n : oldest;
+  return Range(this, first, h);
+}
+
+SensorHistory::Range SensorHistory::since(uint32_t sinceMs) const
+{
+  uint32_t h  = head();
+  uint32_t lo = oldestIndex(h);
+  uint32_t hi = h;
+
+  // Timestamp tăng dần theo chỉ số → tìm nhị phân mẫu đầu tiên >= sinceMs
+  while (lo < hi)
+  {
+    uint32_t mid = lo + (hi - lo) / 2;
+    HistorySample s;
+    if (!read(mid, s) || (int32_t)(s.timestamp_ms - sinceMs) < 0)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  return Range(this, lo, h);
+}
+
+SensorHistory::Range SensorHistory::from(uint32_t index) const
+{
+  uint32_t h      = head();
+  uint32_t oldest = oldestIndex(h);
+  uint32_t first  = (index > oldest) ? index : oldest;
+  if (first > h)
+    first = h;
+  return Range(this, first, h);
+}
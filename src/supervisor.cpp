@@ -0,0 +1,90 @@
+#include "supervisor.h"
+#include "timer_wheel.h"
+#include "task_wifi.h"
+#include "task_webserver.h"
+#include "logger.h"
+
+// ElegantOTA tự restart sau 2s (để kịp trả lời HTTP) nhưng chỉ khi loop() được
+// gọi liên tục; ở đây tự hẹn bằng timer wheel
+#define OTA_REBOOT_DELAY_MS  2000
+
+static StaticEventGroup_t supervisorGroupBuffer;
+static EventGroupHandle_t supervisorGroup = nullptr;
+static WheelTimer         otaRebootTimer;
+
+static void onOtaRebootTimer(void *ctx)
+{
+  xEventGroupSetBits(supervisorGroup, SUP_OTA_REBOOT);
+}
+
+static void onOtaEnd(bool success)
+{
+  if (success)
+    supervisorSignal(SUP_OTA_DONE);
+}
+
+// Chạy trong task sự kiện của Arduino WiFi: chỉ đặt bit
+static void onWifiEvent(WiFiEvent_t event, WiFiEventInfo_t info)
+{
+  switch (event)
+  {
+  case ARDUINO_EVENT_WIFI_STA_GOT_IP:
+    supervisorSignal(SUP_WIFI_UP);
+    break;
+  case ARDUINO_EVENT_WIFI_STA_DISCONNECTED:
+  case ARDUINO_EVENT_WIFI_STA_LOST_IP:
+    supervisorSignal(SUP_WIFI_DOWN);
+    break;
+  default:
+    break;
+  }
+}
+
+void supervisorBegin()
+{
+  supervisorGroup = xEventGroupCreateStatic(&supervisorGroupBuffer);
+  wheelTimerInitCallback(otaRebootTimer, onOtaRebootTimer, nullptr);
+
+  WiFi.onEvent(onWifiEvent);
+
+  ElegantOTA.setAutoReboot(false);
+  ElegantOTA.onEnd(onOtaEnd);
+
+  // Lần chạy đầu: dựng WebServer
+  supervisorSignal(SUP_WEB_STOPPED);
+}
+
+void supervisorSignal(EventBits_t bits)
+{
+  if (supervisorGroup != nullptr)
+    xEventGroupSetBits(supervisorGroup, bits);
+}
+
+void supervisorRun()
+{
+  EventBits_t bits = xEventGroupWaitBits(supervisorGroup, SUP_ALL_BITS,
+                                         pdTRUE, pdFALSE, portMAX_DELAY);
+
+  if (bits & SUP_OTA_REBOOT)
+  {
+    LOGI(SYS, "OTA xong, khởi động lại...");
+    logFlush(200);
+    ESP.restart();
+  }
+
+  if (bits & SUP_OTA_DONE)
+    wheelTimerStart(otaRebootTimer, OTA_REBOOT_DELAY_MS);
+
+  // WebServer nghe trên mọi interface nên đổi trạng thái WiFi không cần dựng lại
+  if (bits & SUP_WEB_STOPPED)
+    Webserver_reconnect();
+
+  if (bits & SUP_WIFI_UP)
+    LOGI(SYS, "WiFi STA có IP");
+  if (bits & SUP_WIFI_DOWN)
+    LOGW(SYS, "WiFi STA mất kết nối");
+
+  // Coroutine WiFi không poll: chỉ kiểm tra lại khi được báo
+  if (bits & (SUP_WIFI_UP | SUP_WIFI_DOWN))
+    Wifi_notify();
+}
@@ -1,7 +1,10 @@
 #include "task_check_info.h"
+#include "heap_stats.h"
+#include "logger.h"
 
 void Load_info_File()
 {
+  HEAP_TAG("config_load");
   File file = LittleFS.open("/info.dat", "r");
   if (!file)
   {
@@ -11,7 +14,7 @@ void Load_info_File()
   DeserializationError error = deserializeJson(doc, file);
   if (error)
   {
-    Serial.print(F("deserializeJson() failed: "));
+    LOGE(SYS, "deserializeJson() failed: %s", error.c_str());
   }
   else
   {
@@ -30,13 +33,14 @@ void Delete_info_File()
   {
     LittleFS.remove("/info.dat");
   }
+  logFlush(200);
   ESP.restart();
 }
 
 void Save_info_File(String wifi_ssid, String wifi_pass, String CORE_IOT_TOKEN, String CORE_IOT_SERVER, String CORE_IOT_PORT)
 {
-  Serial.println(wifi_ssid);
-  Serial.println(wifi_pass);
+  HEAP_TAG("config_save");
+  LOGI(SYS, "Lưu cấu hình WiFi \"%s\", khởi động lại", wifi_ssid);
 
   DynamicJsonDocument doc(4096);
   doc["WIFI_SSID"] = wifi_ssid;
@@ -53,8 +57,9 @@ void Save_info_File(String wifi_ssid, String wifi_pass, String CORE_IOT_TOKEN, S
   }
   else
   {
-    Serial.println("Unable to save the configuration.");
+    LOGE(SYS, "Unable to save the configuration.");
   }
+  logFlush(200);
   ESP.restart();
 };
 
@@ -64,7 +69,7 @@ bool check_info_File(bool check)
   {
     if (!LittleFS.begin(true))
     {
-      Serial.println("❌ Lỗi khởi động LittleFS!");
+      LOGE(SYS, "❌ Lỗi khởi động LittleFS!");
       return false;
     }
     Load_info_File();
@@ -1,5 +1,6 @@
 
 #include "task_core_iot.h"
+#include "logger.h"
 
 constexpr uint32_t MAX_MESSAGE_SIZE = 1024U;
 
@@ -49,10 +50,8 @@ void processSharedAttributes(const Shared_Attribute_Data &data)
 
 RPC_Response setLedSwitchValue(const RPC_Data &data)
 {
-    Serial.println("Received Switch state");
     bool newState = data;
-    Serial.print("Switch state change: ");
-    Serial.println(newState);
+    LOGI(MQTT, "Received Switch state: %d", (int)newState);
     return RPC_Response("setLedSwitchValue", newState);
 }
 
@@ -91,7 +90,7 @@ void CORE_IOT_reconnect()
 
         tb.sendAttributeData("macAddress", WiFi.macAddress().c_str());
 
-        Serial.println("Subscribing for RPC...");
+        LOGI(MQTT, "Subscribing for RPC...");
         if (!tb.RPC_Subscribe(callbacks.cbegin(), callbacks.cend()))
         {
             // Serial.println("Failed to subscribe for RPC");
@@ -104,7 +103,7 @@ void CORE_IOT_reconnect()
             return;
         }
 
-        Serial.println("Subscribe done");
+        LOGI(MQTT, "Subscribe done");
 
         if (!tb.Shared_Attributes_Request(attribute_shared_request_callback))
         {
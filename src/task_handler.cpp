@@ -3,6 +3,16 @@
 #include "task_webserver.h"
 #include "led_blinky.h"
 #include "neo_blinky.h"
+#include "sensor_history.h"
+#include "periodic_timer.h"
+#include "sensor_filter.h"
+#include "adaptive_sampler.h"
+#include "event_bus.h"
+#include "task_table.h"
+#include "executor.h"
+#include "runtime_config.h"
+#include "temp_humi_monitor.h"
+#include "logger.h"
 
 // Giới hạn ms cho pattern LED
 static uint16_t clampMs(uint16_t value)
@@ -50,8 +60,7 @@ void handleWebSocketMessage(String message)
   DeserializationError error = deserializeJson(doc, message);
   if (error)
   {
-    Serial.print("deserializeJson() failed: ");
-    Serial.println(error.c_str());
+    LOGW(WEB, "deserializeJson() failed: %s", error.c_str());
     return;
   }
 
@@ -66,19 +75,20 @@ void handleWebSocketMessage(String message)
     int    gpio   = value["gpio"]   | -1;
     bool isOn = (status == "ON");
 
+    RuntimeConfig &cfg = runtimeConfigEdit();
     if (name == "LED1")
     {
-      glob_temp_led_enabled = isOn;
+      cfg.tempLedEnabled = isOn;
     }
     else if (name == "LED2")
     {
-      glob_humi_led_enabled = isOn;
-
-      if (xHumiNeoSemaphore != nullptr)
-      {
-        xSemaphoreGive(xHumiNeoSemaphore);
-      }
+      cfg.humiLedEnabled = isOn;
     }
+    runtimeConfigCommit();
+
+    // LED / NeoPixel phản hồi ngay qua event bus
+    ConfigChangeEvent ev = {CONFIG_DEVICE_ENABLE};
+    eventPublish(TOPIC_CONFIG_CHANGE, ev);
 
     if (gpio >= 0)
     {
@@ -86,8 +96,7 @@ void handleWebSocketMessage(String message)
       digitalWrite(gpio, isOn ? HIGH : LOW);
     }
 
-    Serial.printf("[WebUI] Device %s (GPIO %d) -> %s\n",
-                  name.c_str(), gpio, isOn ? "ON" : "OFF");
+    LOGI(WEB, "Device %s (GPIO %d) -> %s", name, gpio, isOn ? "ON" : "OFF");
   }
 
   // =========== SETTING: Lưu WiFi / CoreIoT vào LittleFS ===========
@@ -105,12 +114,11 @@ void handleWebSocketMessage(String message)
     CORE_IOT_SERVER= CORE_SERV_local;
     CORE_IOT_PORT  = CORE_PORT_local;
 
-    Serial.println("📥 Nhận cấu hình từ WebSocket:");
-    Serial.println("SSID: " + WIFI_SSID);
-    Serial.println("PASS: " + WIFI_PASS);
-    Serial.println("TOKEN: " + CORE_IOT_TOKEN);
-    Serial.println("SERVER: " + CORE_IOT_SERVER);
-    Serial.println("PORT: " + CORE_IOT_PORT);
+    LOGI(WEB, "📥 Nhận cấu hình từ WebSocket:");
+    // Mật khẩu / token không bao giờ vào log
+    LOGI(WEB, "SSID: %s", WIFI_SSID);
+    LOGI(WEB, "SERVER: %s", CORE_IOT_SERVER);
+    LOGI(WEB, "PORT: %s", CORE_IOT_PORT);
 
     // Gọi hàm lưu cấu hình
     Save_info_File(WIFI_SSID, WIFI_PASS, CORE_IOT_TOKEN, CORE_IOT_SERVER, CORE_IOT_PORT);
@@ -123,10 +131,27 @@ void handleWebSocketMessage(String message)
   // =========== THRESHOLD: Cập nhật ngưỡng nhiệt/ẩm ===========
   else if (page == "threshold")
   {
-    float tCold  = value["tempCold"]  | tempColdThreshold;
-    float tHot   = value["tempHot"]   | tempHotThreshold;
-    float hDry   = value["humiDry"]   | humiDryThreshold;
-    float hHumid = value["humiHumid"] | humiHumidThreshold;
+    // Bản nháp chép từ cấu hình hiện tại; reader chỉ thấy nó sau commit
+    RuntimeConfig &cfg = runtimeConfigEdit();
+    float tCold  = value["tempCold"]  | cfg.tempCold;
+    float tHot   = value["tempHot"]   | cfg.tempHot;
+    float hDry   = value["humiDry"]   | cfg.humiDry;
+    float hHumid = value["humiHumid"] | cfg.humiHumid;
+    float tHyst  = constrain(value["tempHyst"] | cfg.tempHysteresis, 0.0f, 5.0f);
+    float hHyst  = constrain(value["humiHyst"] | cfg.humiHysteresis, 0.0f, 20.0f);
+    uint32_t dwell = min(value["levelDwell"] | cfg.levelDwellMs, (uint32_t)SAMPLER_PERIOD_CEIL_MS);
+
+    // Bộ lọc / oversampling: trường nào không gửi thì giữ nguyên
+    uint32_t filterGen = 0;
+    SensorFilterConfig fc;
+    sensorFilterGetConfig(fc, filterGen);
+    String modeName = value["filterMode"] | sensorFilterModeName(fc.mode);
+    fc.mode       = sensorFilterModeFromName(modeName, fc.mode);
+    fc.oversample = value["oversample"] | fc.oversample;
+    fc.spacing_ms = value["sampleSpacing"] | fc.spacing_ms;
+    fc.ewma_alpha = value["ewmaAlpha"]  | fc.ewma_alpha;
+    fc.kalman_q   = value["kalmanQ"]    | fc.kalman_q;
+    fc.kalman_r   = value["kalmanR"]    | fc.kalman_r;
 
     // Giới hạn độ ẩm 0–100
     if (hDry   < 0.0f)   hDry   = 0.0f;
@@ -152,41 +177,103 @@ void handleWebSocketMessage(String message)
       if (hHumid > 100.0f) hHumid = 100.0f;
     }
 
-    tempColdThreshold  = tCold;
-    tempHotThreshold   = tHot;
-    humiDryThreshold   = hDry;
-    humiHumidThreshold = hHumid;
-
-    Serial.println("🔧 Cập nhật ngưỡng nhiệt/ẩm từ WebUI:");
-    Serial.printf("  TEMP_COLD = %.1f\n", tempColdThreshold);
-    Serial.printf("  TEMP_HOT  = %.1f\n", tempHotThreshold);
-    Serial.printf("  HUMI_DRY  = %.1f\n", humiDryThreshold);
-    Serial.printf("  HUMI_HUMID= %.1f\n", humiHumidThreshold);
+    cfg.tempCold  = tCold;
+    cfg.tempHot   = tHot;
+    cfg.humiDry   = hDry;
+    cfg.humiHumid = hHumid;
+    cfg.tempHysteresis = tHyst;
+    cfg.humiHysteresis = hHyst;
+    cfg.levelDwellMs   = dwell;
+    uint32_t version = runtimeConfigCommit();
+    sensorFilterSetConfig(fc);
+
+    LOGI(WEB, "🔧 Cập nhật ngưỡng nhiệt/ẩm từ WebUI (config v%lu):", (unsigned long)version);
+    LOGI(WEB, "  TEMP_COLD = %.1f", tCold);
+    LOGI(WEB, "  TEMP_HOT  = %.1f", tHot);
+    LOGI(WEB, "  HUMI_DRY  = %.1f", hDry);
+    LOGI(WEB, "  HUMI_HUMID= %.1f", hHumid);
+    LOGI(WEB, "  HYST      = %.1f C / %.1f %%, dwell %lu ms",
+         tHyst, hHyst, (unsigned long)dwell);
+    sensorFilterGetConfig(fc, filterGen);
+    LOGI(WEB, "  FILTER    = %s x%u / %u ms (alpha %.2f, Q %.4f, R %.4f)",
+         sensorFilterModeName(fc.mode), fc.oversample, fc.spacing_ms,
+         fc.ewma_alpha, fc.kalman_q, fc.kalman_r);
+
+    ConfigChangeEvent ev = {CONFIG_THRESHOLDS};
+    eventPublish(TOPIC_CONFIG_CHANGE, ev);
 
     ws.textAll("{\"page\":\"threshold_saved\"}");
   }
 
+  // =========== SAMPLING: Cấu hình lấy mẫu thích ứng ===========
+  else if (page == "sampling")
+  {
+    SamplerConfig sc;
+    adaptiveSampler.getConfig(sc);
+    sc.enabled       = value["enabled"]    | sc.enabled;
+    sc.min_period_ms = value["minPeriod"]  | sc.min_period_ms;
+    sc.max_period_ms = value["maxPeriod"]  | sc.max_period_ms;
+    sc.temp_margin   = value["tempMargin"] | sc.temp_margin;
+    sc.humi_margin   = value["humiMargin"] | sc.humi_margin;
+    sc.temp_slope    = value["tempSlope"]  | sc.temp_slope;
+    sc.humi_slope    = value["humiSlope"]  | sc.humi_slope;
+    sc.growth        = value["growth"]     | sc.growth;
+    adaptiveSampler.setConfig(sc);
+    adaptiveSampler.resetStats();
+
+    adaptiveSampler.getConfig(sc);
+    // Tách 2 record: 5 số thực + chuỗi không vừa payload của một record
+    LOGI(WEB, "⏱️ Lấy mẫu %s: %u..%u ms",
+         sc.enabled ? "thích ứng" : "cố định", sc.min_period_ms, sc.max_period_ms);
+    LOGI(WEB, "  biên %.1f/%.1f, dốc %.1f/%.1f, x%.1f",
+         sc.temp_margin, sc.humi_margin, sc.temp_slope, sc.humi_slope, sc.growth);
+
+    ConfigChangeEvent ev = {CONFIG_SAMPLING};
+    eventPublish(TOPIC_CONFIG_CHANGE, ev);
+
+    ws.textAll("{\"page\":\"sampling_saved\"}");
+  }
+
+  // =========== GET_SAMPLING: Cấu hình + tần số lấy mẫu hiệu dụng ===========
+  else if (page == "get_sampling")
+  {
+    StaticJsonDocument<768> resp;
+    resp["page"] = "sampling_state";
+    JsonObject v = resp.createNestedObject("value");
+    adaptiveSampler.toJson(v);
+    levelStatsToJson(v.createNestedObject("levels"));
+
+    String out;
+    serializeJson(resp, out);
+    Webserver_sendata(out);
+  }
+
   // =========== LED_PATTERN: Cập nhật pattern blink nhiệt độ ===========
   else if (page == "led_pattern")
   {
-    uint16_t coldOn    = clampMs(value["coldOn"]   | tempLedConfig[TEMP_LEVEL_COLD].on_ms);
-    uint16_t coldOff   = clampMs(value["coldOff"]  | tempLedConfig[TEMP_LEVEL_COLD].off_ms);
-    uint16_t normalOn  = clampMs(value["normalOn"] | tempLedConfig[TEMP_LEVEL_NORMAL].on_ms);
-    uint16_t normalOff = clampMs(value["normalOff"]| tempLedConfig[TEMP_LEVEL_NORMAL].off_ms);
-    uint16_t hotOn     = clampMs(value["hotOn"]    | tempLedConfig[TEMP_LEVEL_HOT].on_ms);
-    uint16_t hotOff    = clampMs(value["hotOff"]   | tempLedConfig[TEMP_LEVEL_HOT].off_ms);
-
-    tempLedConfig[TEMP_LEVEL_COLD].on_ms    = coldOn;
-    tempLedConfig[TEMP_LEVEL_COLD].off_ms   = coldOff;
-    tempLedConfig[TEMP_LEVEL_NORMAL].on_ms  = normalOn;
-    tempLedConfig[TEMP_LEVEL_NORMAL].off_ms = normalOff;
-    tempLedConfig[TEMP_LEVEL_HOT].on_ms     = hotOn;
-    tempLedConfig[TEMP_LEVEL_HOT].off_ms    = hotOff;
-
-    Serial.println("💡 Cập nhật pattern LED nhiệt độ:");
-    Serial.printf("  COLD   : %u / %u ms\n", coldOn, coldOff);
-    Serial.printf("  NORMAL : %u / %u ms\n", normalOn, normalOff);
-    Serial.printf("  HOT    : %u / %u ms\n", hotOn, hotOff);
+    RuntimeConfig &cfg = runtimeConfigEdit();
+    uint16_t coldOn    = clampMs(value["coldOn"]   | cfg.tempLed[TEMP_LEVEL_COLD].on_ms);
+    uint16_t coldOff   = clampMs(value["coldOff"]  | cfg.tempLed[TEMP_LEVEL_COLD].off_ms);
+    uint16_t normalOn  = clampMs(value["normalOn"] | cfg.tempLed[TEMP_LEVEL_NORMAL].on_ms);
+    uint16_t normalOff = clampMs(value["normalOff"]| cfg.tempLed[TEMP_LEVEL_NORMAL].off_ms);
+    uint16_t hotOn     = clampMs(value["hotOn"]    | cfg.tempLed[TEMP_LEVEL_HOT].on_ms);
+    uint16_t hotOff    = clampMs(value["hotOff"]   | cfg.tempLed[TEMP_LEVEL_HOT].off_ms);
+
+    cfg.tempLed[TEMP_LEVEL_COLD].on_ms    = coldOn;
+    cfg.tempLed[TEMP_LEVEL_COLD].off_ms   = coldOff;
+    cfg.tempLed[TEMP_LEVEL_NORMAL].on_ms  = normalOn;
+    cfg.tempLed[TEMP_LEVEL_NORMAL].off_ms = normalOff;
+    cfg.tempLed[TEMP_LEVEL_HOT].on_ms     = hotOn;
+    cfg.tempLed[TEMP_LEVEL_HOT].off_ms    = hotOff;
+    runtimeConfigCommit();
+
+    LOGI(WEB, "💡 Cập nhật pattern LED nhiệt độ:");
+    LOGI(WEB, "  COLD   : %u / %u ms", coldOn, coldOff);
+    LOGI(WEB, "  NORMAL : %u / %u ms", normalOn, normalOff);
+    LOGI(WEB, "  HOT    : %u / %u ms", hotOn, hotOff);
+
+    ConfigChangeEvent ev = {CONFIG_LED_PATTERN};
+    eventPublish(TOPIC_CONFIG_CHANGE, ev);
 
     ws.textAll("{\"page\":\"led_pattern_saved\"}");
   }
@@ -198,33 +285,35 @@ void handleWebSocketMessage(String message)
     String okHex    = value["ok"]    | "#00FF00";
     String humidHex = value["humid"] | "#FF0000";
 
+    RuntimeConfig &cfg = runtimeConfigEdit();
     uint8_t r, g, b;
     if (parseHexColor(dryHex, r, g, b))
     {
-      neoColorConfig[HUMI_LEVEL_DRY].r = r;
-      neoColorConfig[HUMI_LEVEL_DRY].g = g;
-      neoColorConfig[HUMI_LEVEL_DRY].b = b;
+      cfg.neoColor[HUMI_LEVEL_DRY].r = r;
+      cfg.neoColor[HUMI_LEVEL_DRY].g = g;
+      cfg.neoColor[HUMI_LEVEL_DRY].b = b;
     }
 
     if (parseHexColor(okHex, r, g, b))
     {
-      neoColorConfig[HUMI_LEVEL_OK].r = r;
-      neoColorConfig[HUMI_LEVEL_OK].g = g;
-      neoColorConfig[HUMI_LEVEL_OK].b = b;
+      cfg.neoColor[HUMI_LEVEL_OK].r = r;
+      cfg.neoColor[HUMI_LEVEL_OK].g = g;
+      cfg.neoColor[HUMI_LEVEL_OK].b = b;
     }
 
     if (parseHexColor(humidHex, r, g, b))
     {
-      neoColorConfig[HUMI_LEVEL_HUMID].r = r;
-      neoColorConfig[HUMI_LEVEL_HUMID].g = g;
-      neoColorConfig[HUMI_LEVEL_HUMID].b = b;
+      cfg.neoColor[HUMI_LEVEL_HUMID].r = r;
+      cfg.neoColor[HUMI_LEVEL_HUMID].g = g;
+      cfg.neoColor[HUMI_LEVEL_HUMID].b = b;
     }
+    runtimeConfigCommit();
 
-    Serial.println("🌈 Cập nhật màu NeoPixel từ WebUI.");
+    LOGI(WEB, "🌈 Cập nhật màu NeoPixel từ WebUI.");
 
     // Kích task NeoPixel cập nhật màu mới
-    if (xHumiNeoSemaphore != nullptr)
-      xSemaphoreGive(xHumiNeoSemaphore);
+    ConfigChangeEvent ev = {CONFIG_NEO_COLOR};
+    eventPublish(TOPIC_CONFIG_CHANGE, ev);
 
     ws.textAll("{\"page\":\"neo_color_saved\"}");
   }
@@ -232,49 +321,68 @@ void handleWebSocketMessage(String message)
   // =========== GET_CONFIG: Gửi toàn bộ cấu hình hiện tại về Web UI ===========
   else if (page == "get_config")
   {
-    StaticJsonDocument<512> resp;
+    StaticJsonDocument<1024> resp;
     resp["page"] = "config";
     JsonObject v = resp.createNestedObject("value");
 
+    // Một ảnh cấu hình cho cả câu trả lời
+    RuntimeConfig cfg;
+    runtimeConfigRead(cfg);
+    v["version"] = cfg.version;
+
     // Ngưỡng nhiệt/ẩm
     JsonObject thr = v.createNestedObject("thresholds");
-    thr["tempCold"]  = tempColdThreshold;
-    thr["tempHot"]   = tempHotThreshold;
-    thr["humiDry"]   = humiDryThreshold;
-    thr["humiHumid"] = humiHumidThreshold;
+    thr["tempCold"]  = cfg.tempCold;
+    thr["tempHot"]   = cfg.tempHot;
+    thr["humiDry"]   = cfg.humiDry;
+    thr["humiHumid"] = cfg.humiHumid;
+    thr["tempHyst"]   = cfg.tempHysteresis;
+    thr["humiHyst"]   = cfg.humiHysteresis;
+    thr["levelDwell"] = cfg.levelDwellMs;
+
+    // Bộ lọc cảm biến (cùng form với ngưỡng)
+    uint32_t filterGen = 0;
+    SensorFilterConfig fc;
+    sensorFilterGetConfig(fc, filterGen);
+    thr["filterMode"] = sensorFilterModeName(fc.mode);
+    thr["oversample"] = fc.oversample;
+    thr["sampleSpacing"] = fc.spacing_ms;
+    thr["ewmaAlpha"]  = fc.ewma_alpha;
+    thr["kalmanQ"]    = fc.kalman_q;
+    thr["kalmanR"]    = fc.kalman_r;
 
     // Pattern LED
     JsonObject lp = v.createNestedObject("ledPattern");
-    lp["coldOn"]    = tempLedConfig[TEMP_LEVEL_COLD].on_ms;
-    lp["coldOff"]   = tempLedConfig[TEMP_LEVEL_COLD].off_ms;
-    lp["normalOn"]  = tempLedConfig[TEMP_LEVEL_NORMAL].on_ms;
-    lp["normalOff"] = tempLedConfig[TEMP_LEVEL_NORMAL].off_ms;
-    lp["hotOn"]     = tempLedConfig[TEMP_LEVEL_HOT].on_ms;
-    lp["hotOff"]    = tempLedConfig[TEMP_LEVEL_HOT].off_ms;
+    lp["coldOn"]    = cfg.tempLed[TEMP_LEVEL_COLD].on_ms;
+    lp["coldOff"]   = cfg.tempLed[TEMP_LEVEL_COLD].off_ms;
+    lp["normalOn"]  = cfg.tempLed[TEMP_LEVEL_NORMAL].on_ms;
+    lp["normalOff"] = cfg.tempLed[TEMP_LEVEL_NORMAL].off_ms;
+    lp["hotOn"]     = cfg.tempLed[TEMP_LEVEL_HOT].on_ms;
+    lp["hotOff"]    = cfg.tempLed[TEMP_LEVEL_HOT].off_ms;
 
     // Màu NeoPixel
     JsonObject neo = v.createNestedObject("neoColors");
-    neo["dry"]   = rgbToHex(neoColorConfig[HUMI_LEVEL_DRY].r,
-                            neoColorConfig[HUMI_LEVEL_DRY].g,
-                            neoColorConfig[HUMI_LEVEL_DRY].b);
-    neo["ok"]    = rgbToHex(neoColorConfig[HUMI_LEVEL_OK].r,
-                            neoColorConfig[HUMI_LEVEL_OK].g,
-                            neoColorConfig[HUMI_LEVEL_OK].b);
-    neo["humid"] = rgbToHex(neoColorConfig[HUMI_LEVEL_HUMID].r,
-                            neoColorConfig[HUMI_LEVEL_HUMID].g,
-                            neoColorConfig[HUMI_LEVEL_HUMID].b);
+    neo["dry"]   = rgbToHex(cfg.neoColor[HUMI_LEVEL_DRY].r,
+                            cfg.neoColor[HUMI_LEVEL_DRY].g,
+                            cfg.neoColor[HUMI_LEVEL_DRY].b);
+    neo["ok"]    = rgbToHex(cfg.neoColor[HUMI_LEVEL_OK].r,
+                            cfg.neoColor[HUMI_LEVEL_OK].g,
+                            cfg.neoColor[HUMI_LEVEL_OK].b);
+    neo["humid"] = rgbToHex(cfg.neoColor[HUMI_LEVEL_HUMID].r,
+                            cfg.neoColor[HUMI_LEVEL_HUMID].g,
+                            cfg.neoColor[HUMI_LEVEL_HUMID].b);
 
     // Trạng thái thiết bị (cho nút gạt LED1, LED2)
     JsonArray devs = v.createNestedArray("devices");
     JsonObject d1 = devs.createNestedObject();
     d1["name"]   = "LED1";
     d1["gpio"]   = LED_GPIO;
-    d1["status"] = glob_temp_led_enabled ? "ON" : "OFF";
+    d1["status"] = cfg.tempLedEnabled ? "ON" : "OFF";
 
     JsonObject d2 = devs.createNestedObject();
     d2["name"]   = "LED2";
     d2["gpio"]   = NEO_PIN;
-    d2["status"] = glob_humi_led_enabled ? "ON" : "OFF";
+    d2["status"] = cfg.humiLedEnabled ? "ON" : "OFF";
 
     // Cấu hình WiFi/CoreIoT để pre-fill vào form Cài đặt
     JsonObject s = v.createNestedObject("settings");
@@ -289,10 +397,64 @@ void handleWebSocketMessage(String message)
     Webserver_sendata(out);
   }
 
+  // =========== GET_HISTORY: Gửi các mẫu gần nhất cho đồ thị ===========
+  else if (page == "get_history")
+  {
+    uint32_t count = value["count"] | 40;
+    if (count > 120) count = 120;
+
+    DynamicJsonDocument resp(256 + count * 48);
+    resp["page"] = "history";
+    JsonArray age  = resp.createNestedArray("age");
+    JsonArray temp = resp.createNestedArray("temp");
+    JsonArray humi = resp.createNestedArray("humi");
+
+    // "age" tính bằng ms so với hiện tại để trình duyệt tự dựng nhãn thời gian
+    uint32_t now = millis();
+    for (const HistorySample &s : sensorHistory.latest(count))
+    {
+      age.add(now - s.timestamp_ms);
+      temp.add(s.temperature());
+      humi.add(s.humidity());
+    }
+
+    String out;
+    serializeJson(resp, out);
+    Webserver_sendata(out);
+  }
+
+  // =========== GET_TIMING: Thống kê jitter / lỡ deadline của các task tuần hoàn ===========
+  else if (page == "get_timing")
+  {
+    DynamicJsonDocument resp(2048);
+    resp["page"] = "timing";
+    PeriodicTimer::statsToJson(resp.createNestedArray("value"));
+
+    String out;
+    serializeJson(resp, out);
+    Webserver_sendata(out);
+  }
+
+  // =========== GET_TASKS: Phân core, stack còn trống và tải từng core ===========
+  else if (page == "get_tasks")
+  {
+    DynamicJsonDocument resp(4096);
+    resp["page"] = "tasks";
+    JsonObject value = resp.createNestedObject("value");
+    static TaskLoadWindow window = {};
+    taskLoadToJson(value, window);
+    taskStackToJson(value.createNestedArray("stacks"));
+    executorStatsToJson(value.createNestedArray("jobs"));
+
+    String out;
+    serializeJson(resp, out);
+    Webserver_sendata(out);
+  }
+
   // =========== RESET_FACTORY: Xóa file cấu hình & restart ===========
   else if (page == "reset_factory")
   {
-    Serial.println("⚠️ Yêu cầu Reset Factory từ Web UI");
+    LOGW(WEB, "⚠️ Yêu cầu Reset Factory từ Web UI");
     Delete_info_File();
   }
 }
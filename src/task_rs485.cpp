@@ -1,4 +1,7 @@
 #include "task_rs485.h"
+#include "periodic_timer.h"
+#include "heap_stats.h"
+#include "logger.h"
 
 HardwareSerial RS485Serial(1);
 
@@ -17,7 +20,7 @@ void sendRS485Command(byte *command, int commandSize, byte *response, int respon
     }
     else
     {
-        Serial.println("Failed to read response - - - - - -");
+        LOGW(BUS, "RS485: failed to read response");
     }
 }
 
@@ -32,6 +35,7 @@ void sendModbusCommand(const uint8_t command[], size_t length)
 
 void _sensor_read()
 {
+    HEAP_TAG("rs485");
     float sound = 0.0;
     float pressure = 0.0;
     byte response[7];
@@ -46,7 +50,7 @@ void _sensor_read()
     }
     else
     {
-        Serial.println("Failed to read sound");
+        LOGW(BUS, "RS485: failed to read sound");
     }
 
     delay(delay_connect);
@@ -60,22 +64,22 @@ void _sensor_read()
     }
     else
     {
-        Serial.println("Failed to read pressure");
+        LOGW(BUS, "RS485: failed to read pressure");
     }
 
     delay(delay_connect);
     memset(response, 0, sizeof(response));
 
-    Serial.println("sound : " + String(sound));
-    Serial.println("pressure: " + String(pressure));
+    LOGI(BUS, "sound: %.2f  pressure: %.2f", sound, pressure);
 }
 
 void Task_Read_Sensor(void *pvParameters)
 {
+    PeriodicTimer readTimer("Task_Read_Sensor", 1000);
     while (true)
     {
         _sensor_read();
-        vTaskDelay(1000 / portTICK_PERIOD_MS);
+        readTimer.wait();
     }
 }
 
@@ -100,45 +104,55 @@ void Task_Send_data(void *pvParameters)
     };
     bool state = false; // false = bật, true = tắt
 
+    // Mỗi bước relay cách nhau đúng 1 s, kể cả thời gian gửi lệnh Modbus
+    PeriodicTimer stepTimer("Task_Send_data", 1000);
+
     while (true)
     {
         if (!state)
         {
-            Serial.println("🟢 Đang bật từng relay...");
+            LOGI(BUS, "🟢 Đang bật từng relay...");
             for (int i = 0; i < 4; i++)
             {
                 sendModbusCommand(relay_ON[i], sizeof(relay_ON[i]));
-                Serial.println("Bật relay " + String(i));
-                vTaskDelay(1000 / portTICK_PERIOD_MS); // Giữ 1 giây giữa mỗi lần bật
+                LOGI(BUS, "Bật relay %d", i);
+                stepTimer.wait(); // Giữ 1 giây giữa mỗi lần bật
             }
         }
         else
         {
-            Serial.println("🔴 Đang tắt từng relay...");
+            LOGI(BUS, "🔴 Đang tắt từng relay...");
             for (int i = 0; i < 4; i++)
             {
                 sendModbusCommand(relay_OFF[i], sizeof(relay_OFF[i]));
-                Serial.println("Tắt relay " + String(i));
-                vTaskDelay(1000 / portTICK_PERIOD_MS); // Giữ 1 giây giữa mỗi lần tắt
+                LOGI(BUS, "Tắt relay %d", i);
+                stepTimer.wait(); // Giữ 1 giây giữa mỗi lần tắt
             }
         }
 
         if (!state)
-            Serial.println("✅ Hoàn tất bật tất cả relay!");
+            LOGI(BUS, "✅ Hoàn tất bật tất cả relay!");
         else
-            Serial.println("✅ Hoàn tất tắt tất cả relay!");
+            LOGI(BUS, "✅ Hoàn tất tắt tất cả relay!");
 
         // Đảo trạng thái cho lần kế tiếp
         state = !state;
 
-        // Nghỉ giữa 2 chu kỳ (3 giây)
-        vTaskDelay(3000 / portTICK_PERIOD_MS);
+        // Nghỉ giữa 2 chu kỳ (3 giây = 3 bước)
+        for (int i = 0; i < 3; i++)
+            stepTimer.wait();
     }
 }
 
 void tasksensor_init()
 {
     RS485Serial.begin(9600, SERIAL_8N1, TXD_RS485, RXD_RS485);
-    xTaskCreate(Task_Read_Sensor, "Task_Read_Sensor", 4096, NULL, 1, NULL);
-    xTaskCreate(Task_Send_data, "Task_Send_data", 4096, NULL, 1, NULL);
+    static StackType_t  readStack[4096];
+    static StaticTask_t readTcb;
+    static StackType_t  sendStack[4096];
+    static StaticTask_t sendTcb;
+    xTaskCreateStaticPinnedToCore(Task_Read_Sensor, "Task_Read_Sensor", sizeof(readStack), NULL, 1,
+                                  readStack, &readTcb, tskNO_AFFINITY);
+    xTaskCreateStaticPinnedToCore(Task_Send_data, "Task_Send_data", sizeof(sendStack), NULL, 1,
+                                  sendStack, &sendTcb, tskNO_AFFINITY);
 }
\ No newline at end of file
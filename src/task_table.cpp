@@ -0,0 +1,192 @@
+#include "task_table.h"
+
+#include "temp_humi_monitor.h"
+#include "tinyml.h"
+#include "coreiot.h"
+#include "i2c_bus.h"
+#include "executor.h"
+#include "logger.h"
+
+// ====== Bảng task ======
+// Kích thước stack (byte): đo lại bằng -DTASK_STACK_DIAG sau mỗi thay đổi lớn
+TASK_STATIC_STORAGE(i2cBus,   3072);
+TASK_STATIC_STORAGE(monitor,  4096);
+TASK_STATIC_STORAGE(tinyMl,   8192);
+TASK_STATIC_STORAGE(coreIot,  4096);
+TASK_STATIC_STORAGE(exec,     3072);
+TASK_STATIC_STORAGE(logDrain, 3072);
+
+// Core 1: chuỗi cảm biến (I2C → lọc → TinyML), ưu tiên giảm dần theo luồng dữ liệu.
+// Core 0: MQTT cạnh WiFi/lwIP/AsyncTCP, cùng executor chạy các job I/O nhẹ
+// (LED, NeoPixel, nút BOOT) để không chen vào chu kỳ lấy mẫu.
+// Drain log ưu tiên thấp nhất: chỉ nó chờ UART / USB-CDC.
+static const TaskSpec TASK_TABLE[] = {
+  // fn                 name                      stack                  prio  core          storage
+  {i2c_bus_task,        "Task I2C Bus",           sizeof(i2cBusStack),   4,    CORE_SENSING, i2cBusStack,   &i2cBusTcb},
+  {temp_humi_monitor,   "Task TEMP HUMI Monitor", sizeof(monitorStack),  3,    CORE_SENSING, monitorStack,  &monitorTcb},
+  {tiny_ml_task,        "Tiny ML Task",           sizeof(tinyMlStack),   2,    CORE_SENSING, tinyMlStack,   &tinyMlTcb},
+  {coreiot_task,        "CoreIOT Task",           sizeof(coreIotStack),  2,    CORE_NETWORK, coreIotStack,  &coreIotTcb},
+  {executor_task,       "Task Executor",          sizeof(execStack),     2,    CORE_NETWORK, execStack,     &execTcb},
+  {log_drain_task,      "Task Log Drain",         sizeof(logDrainStack), 1,    CORE_NETWORK, logDrainStack, &logDrainTcb},
+};
+
+#define TASK_TABLE_SIZE (sizeof(TASK_TABLE) / sizeof(TASK_TABLE[0]))
+
+static TaskHandle_t taskHandles[TASK_TABLE_SIZE];
+
+#ifdef TASK_STACK_DIAG
+TASK_STATIC_STORAGE(stackDiag, 3072);
+
+static void stack_diag_task(void *pvParameters)
+{
+  for (;;)
+  {
+    vTaskDelay(pdMS_TO_TICKS(TASK_STACK_DIAG_PERIOD_MS));
+    taskStackPrint();
+  }
+}
+#endif
+
+void startTaskTable()
+{
+  for (size_t i = 0; i < TASK_TABLE_SIZE; ++i)
+  {
+    const TaskSpec &spec = TASK_TABLE[i];
+    taskHandles[i] = xTaskCreateStaticPinnedToCore(spec.fn, spec.name, spec.stack, nullptr,
+                                                   spec.priority, spec.stackBuf, spec.tcb,
+                                                   spec.core);
+    if (taskHandles[i] == nullptr)
+    {
+      Serial.printf("[Tasks] Không tạo được task %s\n", spec.name);
+    }
+  }
+
+#ifdef TASK_STACK_DIAG
+  xTaskCreateStaticPinnedToCore(stack_diag_task, "Task Stack Diag", sizeof(stackDiagStack),
+                                nullptr, 1, stackDiagStack, &stackDiagTcb, CORE_NETWORK);
+#endif
+}
+
+// ====== Kích thước stack ======
+static uint32_t recommendStack(uint32_t used)
+{
+  uint32_t headroom = used / 4;
+  if (headroom < TASK_STACK_HEADROOM_MIN)
+    headroom = TASK_STACK_HEADROOM_MIN;
+  uint32_t size = used + headroom;
+  return (size + TASK_STACK_ROUND - 1) / TASK_STACK_ROUND * TASK_STACK_ROUND;
+}
+
+// uxTaskGetStackHighWaterMark là mức trống thấp nhất từ lúc task chạy,
+// nên đọc sau khi hệ thống đã chạy đủ tải (WebSocket + MQTT + TinyML)
+static uint32_t stackUsed(size_t index)
+{
+  UBaseType_t freeBytes = uxTaskGetStackHighWaterMark(taskHandles[index]);
+  return TASK_TABLE[index].stack - freeBytes;
+}
+
+void taskStackToJson(JsonArray out)
+{
+  for (size_t i = 0; i < TASK_TABLE_SIZE; ++i)
+  {
+    if (taskHandles[i] == nullptr)
+      continue;
+    uint32_t used = stackUsed(i);
+    JsonObject o = out.createNestedObject();
+    o["name"]      = TASK_TABLE[i].name;
+    o["size"]      = TASK_TABLE[i].stack;
+    o["used"]      = used;
+    o["recommend"] = recommendStack(used);
+  }
+}
+
+void taskStackPrint()
+{
+  int32_t reclaim = 0;
+  Serial.println("[Tasks] Stack: name / size / used / recommend");
+  for (size_t i = 0; i < TASK_TABLE_SIZE; ++i)
+  {
+    if (taskHandles[i] == nullptr)
+      continue;
+    uint32_t used = stackUsed(i);
+    uint32_t rec  = recommendStack(used);
+    reclaim += (int32_t)TASK_TABLE[i].stack - (int32_t)rec;
+    Serial.printf("  %-24s %6lu %6lu %6lu\n", TASK_TABLE[i].name,
+                  (unsigned long)TASK_TABLE[i].stack, (unsigned long)used, (unsigned long)rec);
+  }
+  Serial.printf("[Tasks] Có thể thu hồi %ld byte DRAM\n", (long)reclaim);
+}
+
+// ====== Báo cáo tải ======
+#if configUSE_TRACE_FACILITY
+static void taskEntryToJson(JsonArray tasks, const TaskStatus_t &st, uint32_t totalRunTime)
+{
+  JsonObject o = tasks.createNestedObject();
+  o["name"]  = st.pcTaskName;
+  o["prio"]  = st.uxCurrentPriority;
+  o["core"]  = (st.xCoreID == tskNO_AFFINITY) ? -1 : (int)st.xCoreID;
+  o["stack"] = st.usStackHighWaterMark;   // byte còn trống ít nhất từng gặp
+#if configGENERATE_RUN_TIME_STATS
+  // % thời gian CPU kể từ lúc boot (trên tổng của một core)
+  o["cpu"] = totalRunTime ? (float)st.ulRunTimeCounter * 100.0f / totalRunTime : 0.0f;
+#else
+  (void)totalRunTime;
+#endif
+}
+#endif
+
+void taskLoadToJson(JsonObject out, TaskLoadWindow &window, bool withTasks)
+{
+#if configUSE_TRACE_FACILITY
+  UBaseType_t capacity = uxTaskGetNumberOfTasks() + 4;
+  TaskStatus_t *status = (TaskStatus_t *)malloc(capacity * sizeof(TaskStatus_t));
+  if (status == nullptr)
+    return;
+
+  uint32_t totalRunTime = 0;
+  UBaseType_t count = uxTaskGetSystemState(status, capacity, &totalRunTime);
+
+  if (withTasks)
+  {
+    JsonArray tasks = out.createNestedArray("tasks");
+    for (UBaseType_t i = 0; i < count; ++i)
+      taskEntryToJson(tasks, status[i], totalRunTime);
+  }
+
+#if configGENERATE_RUN_TIME_STATS
+  // Tải core = 1 - phần thời gian idle task của core đó chạy, tính từ lần báo cáo trước
+  uint32_t elapsed = totalRunTime - window.total;
+  JsonArray cores = out.createNestedArray("cores");
+  for (UBaseType_t core = 0; core < portNUM_PROCESSORS; ++core)
+  {
+    TaskHandle_t idle = xTaskGetIdleTaskHandleForCPU(core);
+    uint32_t idleTime = window.idle[core];
+    for (UBaseType_t i = 0; i < count; ++i)
+    {
+      if (status[i].xHandle == idle)
+      {
+        idleTime = status[i].ulRunTimeCounter;
+        break;
+      }
+    }
+
+    uint32_t idleDelta = idleTime - window.idle[core];
+    float load = elapsed ? 100.0f - (float)idleDelta * 100.0f / elapsed : 0.0f;
+    if (load < 0.0f) load = 0.0f;
+
+    JsonObject c = cores.createNestedObject();
+    c["core"] = core;
+    c["load"] = load;
+    window.idle[core] = idleTime;
+  }
+  window.total = totalRunTime;
+  out["windowMs"] = elapsed / 1000;   // bộ đếm runtime của ESP-IDF tính bằng us
+#endif
+
+  free(status);
+#else
+  (void)out;
+  (void)window;
+  (void)withTasks;
+#endif
+}
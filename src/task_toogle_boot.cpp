@@ -1,77 +1,92 @@
 #include "task_toogle_boot.h"
 #include "global.h"
 #include "led_blinky.h" // Để dùng LED_GPIO
+#include "executor.h"
+#include "logger.h"
 #include <WiFi.h>       // [QUAN TRỌNG] Để dùng hàm xóa WiFi WiFi.disconnect()
 
 #define BOOT_BUTTON_PIN 0
 #define HOLD_TIME_MS    3000 // Giữ 3 giây để reset
 
-void Task_Toogle_BOOT(void *pvParameters)
-{
-  pinMode(BOOT_BUTTON_PIN, INPUT_PULLUP); 
+static unsigned long buttonPressStartTime = 0;
+static bool isPressed = false;
+static ExecJob *bootJob = nullptr;
 
-  unsigned long buttonPressStartTime = 0;
-  bool isPressed = false;
+// Mỗi cạnh của nút chỉ báo executor, việc đọc chân và đếm giờ nằm trong job
+static void IRAM_ATTR onBootButtonEdge()
+{
+  executorSignalFromISR(bootJob);
+}
 
-  Serial.println("Task BOOT: San sang. Nhan giu > 3s de Factory Reset.");
+static void factoryReset()
+{
+  LOGW(SYS, "=== FACTORY RESET KICH HOAT ===");
 
-  for (;;)
-  {
-    // Nút BOOT kích hoạt mức THẤP (LOW)
-    if (digitalRead(BOOT_BUTTON_PIN) == LOW)
-    {
-      if (!isPressed)
-      {
-        isPressed = true;
-        buttonPressStartTime = millis();
-        Serial.println(">> Nut BOOT dang duoc nhan...");
-      }
-      else
-      {
-        unsigned long holdDuration = millis() - buttonPressStartTime;
+  // 1. Nháy LED báo hiệu (block executor cũng không sao: sắp restart)
+  pinMode(LED_GPIO, OUTPUT);
+  for(int i=0; i<5; i++){
+      digitalWrite(LED_GPIO, !digitalRead(LED_GPIO));
+      vTaskDelay(pdMS_TO_TICKS(100));
+  }
+  digitalWrite(LED_GPIO, LOW);
 
-        // Nếu giữ quá 3 giây
-        if (holdDuration > HOLD_TIME_MS)
-        {
-          Serial.println("\n[SYSTEM] === FACTORY RESET KICH HOAT ===");
-          
-          // 1. Nháy LED báo hiệu
-          pinMode(LED_GPIO, OUTPUT); 
-          for(int i=0; i<5; i++){
-              digitalWrite(LED_GPIO, !digitalRead(LED_GPIO));
-              vTaskDelay(pdMS_TO_TICKS(100));
-          }
-          digitalWrite(LED_GPIO, LOW);
+  // 2. Xóa file cấu hình trong LittleFS
+  Delete_info_File();
+  LOGI(SYS, "Da xoa file config.");
 
-          // 2. Xóa file cấu hình trong LittleFS
-          Delete_info_File();
-          Serial.println("[SYSTEM] Da xoa file config.");
+  // 3. [QUAN TRỌNG] Xóa WiFi lưu trong bộ nhớ NVS của ESP32
+  // Tham số true thứ nhất: WiFi OFF
+  // Tham số true thứ hai: Erase Configurations (Xóa SSID/Pass lưu trong Flash)
+  WiFi.disconnect(true, true);
+  vTaskDelay(pdMS_TO_TICKS(500)); // Đợi chip xử lý xóa Flash
+  LOGI(SYS, "Da xoa WiFi NVS.");
 
-          // 3. [QUAN TRỌNG] Xóa WiFi lưu trong bộ nhớ NVS của ESP32
-          // Tham số true thứ nhất: WiFi OFF
-          // Tham số true thứ hai: Erase Configurations (Xóa SSID/Pass lưu trong Flash)
-          WiFi.disconnect(true, true);
-          vTaskDelay(pdMS_TO_TICKS(500)); // Đợi chip xử lý xóa Flash
-          Serial.println("[SYSTEM] Da xoa WiFi NVS.");
+  // 4. Khởi động lại
+  LOGI(SYS, "Dang khoi dong lai...");
+  logFlush(200);
+  ESP.restart(); 
+}
 
-          // 4. Khởi động lại
-          Serial.println("[SYSTEM] Dang khoi dong lai...");
-          Serial.flush();
-          ESP.restart(); 
-        }
-      }
-    }
-    else
+// Chạy khi nút đổi trạng thái (ngắt GPIO) hoặc khi hết thời gian giữ (timer wheel):
+// không poll, lúc không ai bấm nút job này không tốn gì
+static uint32_t bootButtonStep(const EventMsg *msg, void *ctx)
+{
+  // Nút BOOT kích hoạt mức THẤP (LOW)
+  if (digitalRead(BOOT_BUTTON_PIN) == LOW)
+  {
+    if (!isPressed)
     {
-      // Nhả nút
-      if (isPressed)
-      {
-        isPressed = false;
-        buttonPressStartTime = 0;
-        Serial.println(">> Da nha nut BOOT.");
-      }
+      isPressed = true;
+      buttonPressStartTime = millis();
+      LOGI(SYS, ">> Nut BOOT dang duoc nhan...");
     }
 
-    vTaskDelay(pdMS_TO_TICKS(100));
+    unsigned long holdDuration = millis() - buttonPressStartTime;
+
+    // Nếu giữ quá 3 giây
+    if (holdDuration >= HOLD_TIME_MS)
+      factoryReset();
+
+    // Hẹn đúng lúc đủ 3 giây; nhả nút sớm sẽ có ngắt báo lại
+    return HOLD_TIME_MS - holdDuration;
+  }
+
+  // Nhả nút (hoặc nảy phím): huỷ hẹn giờ, chờ ngắt kế tiếp
+  if (isPressed)
+  {
+    isPressed = false;
+    buttonPressStartTime = 0;
+    LOGI(SYS, ">> Da nha nut BOOT.");
   }
-}
\ No newline at end of file
+  return EXEC_WAIT_EVENT;
+}
+
+void Task_Toogle_BOOT_init()
+{
+  pinMode(BOOT_BUTTON_PIN, INPUT_PULLUP); 
+
+  LOGI(SYS, "Task BOOT: San sang. Nhan giu > 3s de Factory Reset.");
+  bootJob = executorAdd("boot", 0, bootButtonStep, nullptr);
+  if (bootJob != nullptr)
+    attachInterrupt(digitalPinToInterrupt(BOOT_BUTTON_PIN), onBootButtonEdge, CHANGE);
+}
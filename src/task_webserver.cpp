@@ -1,4 +1,12 @@
 #include "task_webserver.h"
+#include "telemetry_encoder.h"
+#include "supervisor.h"
+#include "metrics.h"
+#include "trace.h"
+#include "latency.h"
+#include "logger.h"
+#include "heap_stats.h"
+#include <memory>
 
 AsyncWebServer server(80);
 AsyncWebSocket ws("/ws");
@@ -10,26 +18,60 @@ void Webserver_sendata(String data)
     if (ws.count() > 0)
     {
         ws.textAll(data); // Gửi đến tất cả client đang kết nối
-        Serial.println("📤 Đã gửi dữ liệu qua WebSocket: " + data);
+        metricInc(METRIC_WS_FRAMES);
+        LOGD(WEB, "📤 Đã gửi dữ liệu qua WebSocket: %s", data);
     }
     else
     {
-        Serial.println("⚠️ Không có client WebSocket nào đang kết nối!");
+        LOGD(WEB, "⚠️ Không có client WebSocket nào đang kết nối!");
     }
 }
 
+// Envelope WebSocket quanh phần thân đã encode sẵn
+static const char TELEMETRY_WS_PREFIX[] = "{\"page\":\"telemetry\",";
+
+void Webserver_sendata(const TelemetryFrame &frame)
+{
+    if (ws.count() == 0)
+        return;
+
+    // Chép 1 lần vào buffer của AsyncWebSocket, mọi client dùng chung buffer này
+    size_t prefixLen = sizeof(TELEMETRY_WS_PREFIX) - 1;
+    AsyncWebSocketMessageBuffer *buffer = ws.makeBuffer(prefixLen + frame.len + 1);
+    if (buffer == nullptr)
+        return;
+
+    uint8_t *out = buffer->get();
+    memcpy(out, TELEMETRY_WS_PREFIX, prefixLen);
+    memcpy(out + prefixLen, frame.body, frame.len);
+    out[prefixLen + frame.len] = '}';
+    ws.textAll(buffer);
+    metricInc(METRIC_WS_FRAMES);
+    // Mỗi mẫu tính độ trễ một lần, ở frame đầu (frame TinyML còn gồm thời gian suy luận)
+    if (!frame.with_ml)
+        latencyRecord(LATENCY_SINK_WS, frame.acquired_us);
+    LOGD(WEB, "📤 Đã gửi telemetry #%lu qua WebSocket", (unsigned long)frame.seq);
+}
+
+void Webserver_subscribeEvents()
+{
+    telemetryAddSink(Webserver_sendata);
+}
+
 void onEvent(AsyncWebSocket *server, AsyncWebSocketClient *client, AwsEventType type, void *arg, uint8_t *data, size_t len)
 {
     if (type == WS_EVT_CONNECT)
     {
-        Serial.printf("WebSocket client #%u connected from %s\n", client->id(), client->remoteIP().toString().c_str());
+        LOGI(WEB, "WebSocket client #%u connected from %s", client->id(), client->remoteIP().toString());
     }
     else if (type == WS_EVT_DISCONNECT)
     {
-        Serial.printf("WebSocket client #%u disconnected\n", client->id());
+        LOGI(WEB, "WebSocket client #%u disconnected", client->id());
     }
     else if (type == WS_EVT_DATA)
     {
+        TRACE_SCOPE("ws_rx");
+        HEAP_TAG("ws_rx");
         AwsFrameInfo *info = (AwsFrameInfo *)arg;
 
         if (info->opcode == WS_TEXT)
@@ -52,6 +94,31 @@ void connnectWSV()
               { request->send(LittleFS, "/script.js", "application/javascript"); });
     server.on("/styles.css", HTTP_GET, [](AsyncWebServerRequest *request)
               { request->send(LittleFS, "/styles.css", "text/css"); });
+    // Metrics runtime (heap, CPU / stack từng task, bộ đếm) cho dashboard và công cụ ngoài
+    server.on("/metrics", HTTP_GET, [](AsyncWebServerRequest *request)
+              {
+                  HEAP_TAG("metrics");
+                  DynamicJsonDocument doc(6144);
+                  metricsToJson(doc.to<JsonObject>());
+                  AsyncResponseStream *response = request->beginResponseStream("application/json");
+                  serializeJson(doc, *response);
+                  request->send(response); });
+#ifdef TRACE_ENABLED
+    // Trace sự kiện dạng Chrome JSON, gửi từng chunk từ ảnh chụp ring
+    server.on("/trace", HTTP_GET, [](AsyncWebServerRequest *request)
+              {
+                  std::shared_ptr<TraceExport> trace(new TraceExport());
+                  if (!trace->ok())
+                  {
+                      request->send(503, "text/plain", "Not enough memory for trace snapshot");
+                      return;
+                  }
+                  AsyncWebServerResponse *response = request->beginChunkedResponse("application/json",
+                      [trace](uint8_t *buffer, size_t maxLen, size_t index) -> size_t
+                      { return trace->read((char *)buffer, maxLen); });
+                  response->addHeader("Content-Disposition", "attachment; filename=\"trace.json\"");
+                  request->send(response); });
+#endif
     server.begin();
     ElegantOTA.begin(&server);
     webserver_isrunning = true;
@@ -62,13 +129,15 @@ void Webserver_stop()
     ws.closeAll();
     server.end();
     webserver_isrunning = false;
+    // Supervisor dựng lại WebServer như loop() cũ từng làm
+    supervisorSignal(SUP_WEB_STOPPED);
 }
 
+// Gọi từ supervisor khi có SUP_WEB_STOPPED; restart sau OTA do supervisor hẹn
 void Webserver_reconnect()
 {
     if (!webserver_isrunning)
     {
         connnectWSV();
     }
-    ElegantOTA.loop();
 }
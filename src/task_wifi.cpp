@@ -1,46 +1,71 @@
 #include "task_wifi.h"
+#include "coroutine.h"
+#include "logger.h"
 
 void startAP()
 {
     WiFi.mode(WIFI_AP);
     WiFi.softAP(String(SSID_AP), String(PASS_AP));
-    Serial.print("AP IP: ");
-    Serial.println(WiFi.softAPIP());
+    LOGI(SYS, "AP IP: %s", WiFi.softAPIP().toString());
 }
 
-void startSTA()
+#define STA_CONNECT_TIMEOUT_MS  15000   // để không treo vĩnh viễn ở 1 lần thử
+
+static CoState wifiCo;
+static ExecJob *wifiJob = nullptr;
+
+static bool startSTA()
 {
     if (WIFI_SSID.isEmpty())
     {
         // Không có SSID thì khỏi kết nối STA
-        return;
+        return false;
     }
 
     WiFi.mode(WIFI_STA);
 
     if (WIFI_PASS.isEmpty()) WiFi.begin(WIFI_SSID.c_str());
     else                     WiFi.begin(WIFI_SSID.c_str(), WIFI_PASS.c_str());
+    return true;
+}
 
-    uint32_t t0 = millis();
-    while (WiFi.status() != WL_CONNECTED)
+// Coroutine: có cấu hình → kết nối STA → báo Internet → chờ mất kết nối → lặp lại.
+// Chạy trên executor nên loop() / WebServer không còn bị chặn 15s mỗi lần thử.
+// Không poll WiFi.status(): supervisor gọi Wifi_notify() khi có sự kiện WiFi.
+static uint32_t wifiStep(const EventMsg *msg, void *ctx)
+{
+    CO_BEGIN(wifiCo);
+
+    for (;;)
     {
-        vTaskDelay(pdMS_TO_TICKS(100));
-        if (millis() - t0 > 15000) {   // timeout 15s để không treo vĩnh viễn
-            Serial.println("❌ STA connect timeout");
-            return;
+        // Chưa có cấu hình thì nằm yên: lưu cấu hình sẽ restart thiết bị
+        CO_WAIT(wifiCo, check_info_File(true) && startSTA());
+
+        CO_WAIT_FOR(wifiCo, WiFi.status() == WL_CONNECTED, STA_CONNECT_TIMEOUT_MS);
+        if (!wifiCo.ok)
+        {
+            LOGW(SYS, "❌ STA connect timeout");
+            continue;
         }
-    }
 
-    Serial.print("✅ STA IP: ");
-    Serial.println(WiFi.localIP());
+        LOGI(SYS, "✅ STA IP: %s", WiFi.localIP().toString());
+        isWifiConnected = true;
+        xSemaphoreGive(xBinarySemaphoreInternet);
+
+        CO_WAIT(wifiCo, WiFi.status() != WL_CONNECTED);
+        isWifiConnected = false;
+        LOGW(SYS, "⚠️ Mất kết nối WiFi STA");
+    }
 
-    xSemaphoreGive(xBinarySemaphoreInternet);
+    CO_END(wifiCo);
 }
 
-bool Wifi_reconnect()
+void Wifi_init()
 {
-    if (WiFi.status() == WL_CONNECTED) return true;
+    wifiJob = executorAdd("wifi", 0, wifiStep, nullptr);
+}
 
-    startSTA();
-    return (WiFi.status() == WL_CONNECTED);
+void Wifi_notify()
+{
+    executorSignal(wifiJob);
 }
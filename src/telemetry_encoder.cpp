@@ -0,0 +1,178 @@
+#include "telemetry_encoder.h"
+#include "event_bus.h"
+#include "fixed_point.h"
+#include "trace.h"
+
+static TelemetryFrame framePool[TELEMETRY_FRAME_POOL];
+static TelemetryFrame *latestFrame = nullptr;
+static uint32_t frameSeq = 0;
+static portMUX_TYPE telemetryMux = portMUX_INITIALIZER_UNLOCKED;
+
+static TelemetrySink sinks[TELEMETRY_MAX_SINKS];
+static uint8_t sinkCount = 0;
+
+// Mẫu vừa encode: kết quả TinyML chỉ được ghép với đúng mẫu này
+static SensorSnapshot lastSample;
+static bool haveSample = false;
+
+// ====== Pool frame ======
+static TelemetryFrame *allocFrame()
+{
+  TelemetryFrame *frame = nullptr;
+  portENTER_CRITICAL(&telemetryMux);
+  for (int i = 0; i < TELEMETRY_FRAME_POOL; ++i)
+  {
+    if (framePool[i].refs == 0)
+    {
+      frame = &framePool[i];
+      frame->refs = 1;
+      break;
+    }
+  }
+  portEXIT_CRITICAL(&telemetryMux);
+  return frame;
+}
+
+TelemetryFrame *telemetryAcquireLatest()
+{
+  portENTER_CRITICAL(&telemetryMux);
+  TelemetryFrame *frame = latestFrame;
+  if (frame != nullptr)
+    frame->refs++;
+  portEXIT_CRITICAL(&telemetryMux);
+  return frame;
+}
+
+void telemetryRelease(TelemetryFrame *frame)
+{
+  if (frame == nullptr)
+    return;
+  portENTER_CRITICAL(&telemetryMux);
+  frame->refs--;
+  portEXIT_CRITICAL(&telemetryMux);
+}
+
+// ====== Encode ======
+static uint16_t encodeBody(char *out, size_t size, const SensorSnapshot &snap,
+                           const MlResultEvent *ml)
+{
+  char tempText[12];
+  char humiText[12];
+  // Snapshot luôn có bản centi (cả build float): format nguyên, không printf float
+  formatCenti(tempText, sizeof(tempText), snap.temp_centi, 2);
+  formatCenti(humiText, sizeof(humiText), snap.humi_centi, 2);
+
+  int n = snprintf(out, size, "\"temperature\":%s,\"humidity\":%s", tempText, humiText);
+
+  if (ml != nullptr && n > 0 && (size_t)n < size)
+  {
+    n += snprintf(out + n, size - n,
+                  ",\"tiny_score\":%.3f,\"tiny_pred\":\"%s\",\"tiny_gt\":\"%s\",\"tiny_acc\":%.1f",
+                  ml->score,
+                  ml->pred_anomaly ? "ANOM" : "OK",
+                  ml->gt_anomaly ? "ANOM" : "OK",
+                  ml->accuracy);
+  }
+
+  if (n < 0 || (size_t)n >= size)
+    return 0;
+  return (uint16_t)n;
+}
+
+// Encode một frame rồi giao cho sink và ô latest. Frame của mẫu cũ hơn latest
+// (kết quả TinyML tới sau khi mẫu kế tiếp đã được phát) bị bỏ.
+static void emitFrame(const SensorSnapshot &snap, const MlResultEvent *ml)
+{
+  TelemetryFrame *frame = allocFrame();
+  if (frame == nullptr)
+    return;   // sink chậm vẫn giữ đủ frame: bỏ frame này, frame sau sẽ có
+
+  frame->len = encodeBody(frame->body, sizeof(frame->body), snap, ml);
+  frame->sample_seq  = snap.seq;
+  frame->with_ml     = ml != nullptr;
+  frame->acquired_us = snap.acquired_us;
+  if (frame->len == 0)
+  {
+    telemetryRelease(frame);
+    return;
+  }
+
+  // Ref của encoder chuyển sang ô latest; thêm 1 ref cho lúc gọi sink vì
+  // task kia có thể thay latest ngay sau đó
+  portENTER_CRITICAL(&telemetryMux);
+  TelemetryFrame *old = latestFrame;
+  bool stale = old != nullptr && (int32_t)(snap.seq - old->sample_seq) < 0;
+  if (!stale)
+  {
+    frame->seq  = ++frameSeq;
+    frame->refs++;
+    latestFrame = frame;
+    if (old != nullptr)
+      old->refs--;
+  }
+  portEXIT_CRITICAL(&telemetryMux);
+
+  if (stale)
+  {
+    telemetryRelease(frame);
+    return;
+  }
+
+  for (uint8_t i = 0; i < sinkCount; ++i)
+    sinks[i](*frame);
+  telemetryRelease(frame);
+}
+
+static void onSample(const SensorSnapshot &snap)
+{
+  TRACE_SCOPE("telemetry_json");
+  portENTER_CRITICAL(&telemetryMux);
+  lastSample = snap;
+  haveSample = true;
+  portEXIT_CRITICAL(&telemetryMux);
+
+  emitFrame(snap, nullptr);
+}
+
+static void onMlResult(const MlResultEvent &ml)
+{
+  SensorSnapshot snap;
+  bool match;
+  portENTER_CRITICAL(&telemetryMux);
+  snap  = lastSample;
+  match = haveSample && lastSample.seq == ml.sample_seq;
+  portEXIT_CRITICAL(&telemetryMux);
+
+  // Đã có mẫu mới hơn: kết quả này thuộc mẫu cũ, không ghép
+  if (!match)
+    return;
+
+  TRACE_SCOPE("telemetry_json");
+  emitFrame(snap, &ml);
+}
+
+static void onBusEvent(const EventMsg *msg, void *ctx)
+{
+  if (msg->topic == TOPIC_SENSOR_SAMPLE)
+  {
+    onSample(msg->as<SensorSnapshot>());
+  }
+  else if (msg->topic == TOPIC_ML_RESULT)
+  {
+    onMlResult(msg->as<MlResultEvent>());
+  }
+}
+
+void telemetryEncoderBegin()
+{
+  eventSubscribeCallback(TOPIC_MASK(TOPIC_SENSOR_SAMPLE) | TOPIC_MASK(TOPIC_ML_RESULT),
+                         onBusEvent, nullptr);
+}
+
+bool telemetryAddSink(TelemetrySink sink)
+{
+  if (sink == nullptr || sinkCount >= TELEMETRY_MAX_SINKS)
+    return false;
+  sinks[sinkCount++] = sink;
+  return true;
+}
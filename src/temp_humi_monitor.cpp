@@ -1,98 +1,340 @@
 #include "temp_humi_monitor.h"
 #include <Wire.h>
 #include <ArduinoJson.h>
-#include "task_webserver.h"
+#include "sensor_history.h"
+#include "i2c_bus.h"
+#include "periodic_timer.h"
+#include "sensor_filter.h"
+#include "adaptive_sampler.h"
+#include "fixed_point.h"
+#include "event_bus.h"
+#include "runtime_config.h"
+#include "level_tracker.h"
+#include "metrics.h"
+#include "trace.h"
+#include "latency.h"
+#include "logger.h"
+#include <esp_timer.h>
+
+// Kiểu giá trị trong vòng lấy mẫu: float mặc định, 0.01 đơn vị khi build với
+// -D SENSOR_FIXED_POINT (không đụng tới float từ DHT20 tới JSON/LCD).
+#ifdef SENSOR_FIXED_POINT
+typedef centi_t sample_t;
+#define SAMPLE_ERROR_VALUE  (-100)
+#else
+typedef float sample_t;
+#define SAMPLE_ERROR_VALUE  (-1.0f)
+#endif
 
 DHT20 dht20;
 // I2C LCD: address 33 (0x21), 16x2
 LiquidCrystal_I2C lcd(33, 16, 2);
+// Framebuffer bóng: chỉ gửi các ô thay đổi thay vì clear() + in lại cả màn
+static LcdFrameBuffer lcdFb(lcd);
+
+// Bộ lọc riêng cho từng kênh, bộ đệm mẫu cố định (không cấp phát động)
+static SensorFilter tempFilter;
+static SensorFilter humiFilter;
+static sample_t tempSamples[SENSOR_FILTER_MAX_OVERSAMPLE];
+static sample_t humiSamples[SENSOR_FILTER_MAX_OVERSAMPLE];
+// Cấu hình lọc của chu kỳ gần nhất (log + độ dài chu kỳ tối thiểu)
+static uint8_t  filterMode       = SENSOR_FILTER_NONE;
+static uint8_t  filterSamples    = 0;
+static uint8_t  filterOversample = 1;
+static uint16_t filterSpacingMs  = SENSOR_FILTER_MIN_SPACING_MS;
+
+// Mức nhiệt / ẩm sau hysteresis + dwell; chỉ task monitor cập nhật
+static LevelTracker tempTracker(TEMP_LEVEL_NORMAL);
+static LevelTracker humiTracker(HUMI_LEVEL_OK);
+
+// Dữ liệu cho một lần vẽ LCD (job chạy trên task I2C bus)
+struct LcdFrame {
+  sample_t     temperature;
+  sample_t     humidity;
+  DisplayState state;
+  uint32_t     acquiredUs;   // mốc đọc DHT20 của mẫu, đo độ trễ tới LCD
+};
 
+static int acquireSample(sample_t &temperature, sample_t &humidity);
+static void waitSampleSpacing(uint32_t spacingMs);
+static int acquireFiltered(sample_t &temperature, sample_t &humidity);
 static DisplayState computeDisplayState(uint8_t tempLevel, uint8_t humiLevel);
-static void updateLcd(float temperature, float humidity, DisplayState state);
-static void sendSensorToWeb(float temperature, float humidity);
+static void updateLcd(sample_t temperature, sample_t humidity, DisplayState state,
+                      uint32_t acquiredUs);
+static void lcdOnSample(const EventMsg *msg, void *ctx);
+
+// ====== Phép toán theo kiểu mẫu (float / centi_t) ======
+static inline float toFloat(float v)   { return v; }
+static inline float toFloat(centi_t v) { return centiToFloat(v); }
+
+static inline centi_t toCenti(float v)   { return centiFromFloat(v); }
+static inline centi_t toCenti(centi_t v) { return v; }
+
+static inline bool isValidSample(float v)   { return !isnan(v); }
+static inline bool isValidSample(centi_t v) { return true; }
+
+static inline void readConverted(float &temperature, float &humidity)
+{
+  temperature = dht20.getTemperature();
+  humidity    = dht20.getHumidity();
+}
+
+static inline void readConverted(centi_t &temperature, centi_t &humidity)
+{
+  temperature = dht20.getTemperatureCenti();
+  humidity    = dht20.getHumidityCenti();
+}
+
+static inline void publish(float temperature, float humidity,
+                    uint8_t tempLevel, uint8_t humiLevel, bool valid, uint32_t acquiredUs)
+{
+  publishSensorSnapshot(temperature, humidity, tempLevel, humiLevel, acquiredUs);
+  if (valid)
+    sensorHistory.push(millis(), temperature, humidity);
+}
+
+static inline void publish(centi_t temperature, centi_t humidity,
+                    uint8_t tempLevel, uint8_t humiLevel, bool valid, uint32_t acquiredUs)
+{
+  publishSensorSnapshotCenti(temperature, humidity, tempLevel, humiLevel, acquiredUs);
+  if (valid)
+    sensorHistory.pushCenti(millis(), temperature, humidity);
+}
+
+static inline void snapshotValues(const SensorSnapshot &snap, float &temperature, float &humidity)
+{
+  temperature = snap.temperature;
+  humidity    = snap.humidity;
+}
+
+static inline void snapshotValues(const SensorSnapshot &snap, centi_t &temperature, centi_t &humidity)
+{
+  temperature = snap.temp_centi;
+  humidity    = snap.humi_centi;
+}
+
+// Bản float cũng format qua centi: một phép nhân float, không printf double
+static inline size_t formatSample(char *buf, size_t len, float v, uint8_t decimals)
+{
+  return formatCenti(buf, len, centiFromFloat(v), decimals);
+}
+
+static inline size_t formatSample(char *buf, size_t len, centi_t v, uint8_t decimals)
+{
+  return formatCenti(buf, len, v, decimals);
+}
+
+static bool lcdInitJob(TwoWire &wire, void *arg);
+static bool lcdUpdateJob(TwoWire &wire, void *arg);
+static bool dhtProbeJob(TwoWire &wire, void *arg);
+static bool dhtTriggerJob(TwoWire &wire, void *arg);
+static bool dhtCollectJob(TwoWire &wire, void *arg);
 
 void temp_humi_monitor(void *pvParameters)
 {
-  Wire.begin(11, 12);
-  dht20.begin();
+  // Wire thuộc về task I2C bus; ở đây chỉ gửi job qua hàng đợi
+  if (!i2cBusRun(dhtProbeJob, nullptr, I2C_BUS_FAST_HZ, 100))
+    LOGE(SENSOR, "DHT20 not found on I2C bus");
 
-  lcd.begin();
-  lcd.backlight();
-  lcd.clear();
-  lcd.setCursor(0, 0);
-  lcd.print("DHT20 starting...");
-  lcd.setCursor(0, 1);
-  lcd.print("Please wait");
+  // lcd.begin() có delay ~1 s theo datasheet HD44780 → timeout rộng
+  i2cBusRun(lcdInitJob, nullptr, I2C_BUS_STD_HZ, 3000);
   vTaskDelay(pdMS_TO_TICKS(1500));
 
-  uint8_t lastTempLevel = glob_temp_level;
-  uint8_t lastHumiLevel = glob_humi_level;
+  uint8_t lastTempLevel = TEMP_LEVEL_NORMAL;
+  uint8_t lastHumiLevel = HUMI_LEVEL_OK;
+
+  // LCD vẽ lại theo từng mẫu được phát; kết quả TinyML gần nhất cho bộ lấy mẫu
+  eventSubscribeCallback(TOPIC_MASK(TOPIC_SENSOR_SAMPLE), lcdOnSample, nullptr);
+  EventSubscription *mlSub = eventSubscribeLatest(TOPIC_MASK(TOPIC_ML_RESULT));
+  bool anomaly = false;
+
+  // Chu kỳ lấy mẫu tính theo deadline; độ dài do adaptiveSampler chọn mỗi vòng
+  PeriodicTimer sampleTimer("temp_humi_monitor", 2000);
+
+  // Ảnh cấu hình dùng cho cả vòng; chỉ chép lại khi version đổi
+  RuntimeConfig rc;
+  runtimeConfigRead(rc);
 
   for (;;)
   {
-    dht20.read();
-    float temperature = dht20.getTemperature();
-    float humidity    = dht20.getHumidity();
+    runtimeConfigRead(rc, rc.version);
+
+    sample_t temperature = 0;
+    sample_t humidity    = 0;
+    TRACE_BEGIN("dht_read");
+    int status = acquireFiltered(temperature, humidity);
+    TRACE_END("dht_read");
+    // Mốc đầu của độ trễ đầu-cuối, đi theo mẫu tới WebSocket / MQTT / LCD
+    uint32_t acquiredUs = (uint32_t)esp_timer_get_time();
 
-    if (isnan(temperature) || isnan(humidity))
+    if (status != DHT20_OK || !isValidSample(temperature) || !isValidSample(humidity))
     {
-      Serial.println("Failed to read from DHT20!");
-      temperature = -1.0f;
-      humidity    = -1.0f;
+      LOGW(SENSOR, "Failed to read from DHT20! (rc=%d)", status);
+      status      = (status == DHT20_OK) ? DHT20_ERROR_CHECKSUM : status;
+      temperature = SAMPLE_ERROR_VALUE;
+      humidity    = SAMPLE_ERROR_VALUE;
     }
 
-    // Cập nhật giá trị thô toàn cục
-    glob_temperature = temperature;
-    glob_humidity    = humidity;
-
-    // Phân loại mức nhiệt theo ngưỡng runtime
-    uint8_t tempLevel = TEMP_LEVEL_NORMAL;
-    if (temperature < tempColdThreshold)
-      tempLevel = TEMP_LEVEL_COLD;
-    else if (temperature > tempHotThreshold)
-      tempLevel = TEMP_LEVEL_HOT;
-
-    // Phân loại mức ẩm theo ngưỡng runtime
-    uint8_t humiLevel = HUMI_LEVEL_OK;
-    if (humidity < humiDryThreshold)
-      humiLevel = HUMI_LEVEL_DRY;
-    else if (humidity > humiHumidThreshold)
-      humiLevel = HUMI_LEVEL_HUMID;
-
-    glob_temp_level = tempLevel;
-    glob_humi_level = humiLevel;
-
-    // ====== Semaphore cho Task 1 & 2 ======
-    if (tempLevel != lastTempLevel && xTempLedSemaphore != nullptr)
+    // Phân loại mức nhiệt / ẩm theo ngưỡng runtime, có hysteresis + dwell.
+    // Mẫu lỗi giữ nguyên mức cũ thay vì kéo về LẠNH / KHÔ.
+    uint8_t tempLevel = tempTracker.level();
+    uint8_t humiLevel = humiTracker.level();
+    if (status == DHT20_OK)
     {
-      xSemaphoreGive(xTempLedSemaphore);
-      lastTempLevel = tempLevel;
+      uint32_t now = millis();
+      tempLevel = tempTracker.update(toCenti(temperature), centiFromFloat(rc.tempCold),
+                                     centiFromFloat(rc.tempHot),
+                                     centiFromFloat(rc.tempHysteresis),
+                                     rc.levelDwellMs, now);
+      humiLevel = humiTracker.update(toCenti(humidity), centiFromFloat(rc.humiDry),
+                                     centiFromFloat(rc.humiHumid),
+                                     centiFromFloat(rc.humiHysteresis),
+                                     rc.levelDwellMs, now);
     }
 
-    if (humiLevel != lastHumiLevel && xHumiNeoSemaphore != nullptr)
+    EventMsg *ml = eventReceive(mlSub, 0);
+    if (ml != nullptr)
     {
-      xSemaphoreGive(xHumiNeoSemaphore);
-      lastHumiLevel = humiLevel;
+      anomaly = ml->as<MlResultEvent>().pred_anomaly;
+      eventRelease(ml);
     }
 
-    // ====== LCD 3 trạng thái ======
+    // Ổn định & xa ngưỡng → giãn chu kỳ; gần ngưỡng / đổi nhanh / bất thường → nhanh
+    uint32_t period = adaptiveSampler.next(millis(), status == DHT20_OK,
+                                           toFloat(temperature), toFloat(humidity),
+                                           anomaly, rc);
+    // Chu kỳ phải chứa đủ N lần đo cách nhau spacing, nếu không lần đo đầu
+    // của chu kỳ sau phải chờ và deadline bị lỡ
+    uint32_t minPeriod = (uint32_t)filterOversample * (filterSpacingMs + DHT20_MEASURE_TIME_MS);
+    if (period < minPeriod)
+      period = minPeriod;
+    sampleTimer.setPeriod(period);
+
     DisplayState state = computeDisplayState(tempLevel, humiLevel);
     glob_display_state = state;
-    updateLcd(temperature, humidity, state);
 
-    // Gửi dữ liệu lên webserver qua WebSocket
-    sendSensorToWeb(temperature, humidity);
+    // Publish cả mẫu một lần để reader thấy cặp giá trị nhất quán;
+    // lịch sử bỏ qua mẫu lỗi để không làm bẩn đồ thị
+    publish(temperature, humidity, tempLevel, humiLevel, status == DHT20_OK, acquiredUs);
+    metricInc(status == DHT20_OK ? METRIC_SENSOR_SAMPLES : METRIC_SENSOR_ERRORS);
 
-    Serial.print("[DHT20] H: ");
-    Serial.print(humidity);
-    Serial.print("%  T: ");
-    Serial.print(temperature);
-    Serial.println(" C");
+    // Phát mẫu lên bus: LCD, WebSocket, MQTT, TinyML tự nhận
+    SensorSnapshot snap;
+    readSensorSnapshot(snap);
+    TRACE_BEGIN("sample_publish");
+    eventPublish(TOPIC_SENSOR_SAMPLE, snap);
+    TRACE_END("sample_publish");
 
-    vTaskDelay(pdMS_TO_TICKS(2000));
+    // ====== Báo đổi mức cho LED / NeoPixel ======
+    uint8_t changed = 0;
+    if (tempLevel != lastTempLevel) changed |= LEVEL_CHANGED_TEMP;
+    if (humiLevel != lastHumiLevel) changed |= LEVEL_CHANGED_HUMI;
+    if (changed != 0)
+    {
+      LevelChangeEvent ev = {tempLevel, humiLevel, (uint8_t)state, changed};
+      eventPublish(TOPIC_LEVEL_CHANGE, ev);
+      lastTempLevel = tempLevel;
+      lastHumiLevel = humiLevel;
+    }
+
+    char humiText[12];
+    char tempText[12];
+    formatSample(humiText, sizeof(humiText), humidity, 2);
+    formatSample(tempText, sizeof(tempText), temperature, 2);
+
+    // Bus: thời gian task thực sự bận (trigger + collect); blocking: thời gian
+    // read() chặn caller cho cùng một lần đo (trigger → dữ liệu đã chuyển đổi)
+    LOGI(SENSOR, "H: %s%%  T: %s C  [%s x%u] (bus %lu us, blocking %lu us, LCD %u B, next %lu ms)",
+         humiText, tempText, sensorFilterModeName(filterMode), filterSamples,
+         (unsigned long)(dht20.triggerMicros() + dht20.collectMicros()),
+         (unsigned long)dht20.blockingMicros(),
+         (unsigned)lcdFb.lastFlushBytes(), (unsigned long)period);
+
+    sampleTimer.wait();
   }
 }
 
+// Đo N lần trong chu kỳ, cách nhau spacing_ms, rồi đưa qua bộ lọc đang chọn.
+// Lần đo lỗi bị bỏ qua; chỉ báo lỗi khi không lần nào thành công.
+static int acquireFiltered(sample_t &temperature, sample_t &humidity)
+{
+  static uint32_t generation = 0;
+  SensorFilterConfig cfg;
+  if (sensorFilterGetConfig(cfg, generation))
+  {
+    // Đổi bộ lọc / tham số → bỏ trạng thái cũ, tránh quá độ sai
+    tempFilter.reset();
+    humiFilter.reset();
+  }
+
+  uint8_t count = 0;
+  int status = DHT20_ERROR_CONNECT;
+  for (uint8_t i = 0; i < cfg.oversample; ++i)
+  {
+    // Tính từ lần đọc trước, kể cả lần cuối của chu kỳ trước
+    waitSampleSpacing(cfg.spacing_ms);
+
+    sample_t t = 0;
+    sample_t h = 0;
+    int rc = acquireSample(t, h);
+    if (rc == DHT20_OK && isValidSample(t) && isValidSample(h))
+    {
+      tempSamples[count] = t;
+      humiSamples[count] = h;
+      count++;
+    }
+    else
+      status = rc;
+  }
+
+  filterMode       = cfg.mode;
+  filterSamples    = count;
+  filterOversample = cfg.oversample;
+  filterSpacingMs  = cfg.spacing_ms;
+  if (count == 0)
+    return status;
+
+  temperature = tempFilter.update(tempSamples, count, cfg);
+  humidity    = humiFilter.update(humiSamples, count, cfg);
+  return DHT20_OK;
+}
+
+static void waitSampleSpacing(uint32_t spacingMs)
+{
+  uint32_t sinceRead = millis() - dht20.lastRead();
+  if (sinceRead < spacingMs)
+    vTaskDelay(pdMS_TO_TICKS(spacingMs - sinceRead) + 1);   // +1 tick: làm tròn lên
+}
+
+// Đọc DHT20 không chặn: kích đo, ngủ trong lúc cảm biến chuyển đổi (~80 ms)
+// rồi mới lấy dữ liệu. Task nhường CPU thay vì vòng lặp isMeasuring().
+static int acquireSample(sample_t &temperature, sample_t &humidity)
+{
+  int status = DHT20_ERROR_CONNECT;
+  if (!i2cBusRun(dhtTriggerJob, &status, I2C_BUS_FAST_HZ, 50))
+    return DHT20_ERROR_CONNECT;
+  if (status != DHT20_OK)
+    return status;
+
+  vTaskDelay(pdMS_TO_TICKS(DHT20_MEASURE_TIME_MS));
+
+  // Hiếm khi cảm biến chưa xong (hoặc tick làm tròn thiếu, collect trả BUSY
+  // mà không đụng bus): chờ thêm từng nhịp ngắn, có giới hạn
+  status = DHT20_ERROR_CONNECT;
+  i2cBusRun(dhtCollectJob, &status, I2C_BUS_FAST_HZ, 50);
+  for (int retry = 0; status == DHT20_ERROR_BUSY && retry < 5; ++retry)
+  {
+    vTaskDelay(pdMS_TO_TICKS(10));
+    i2cBusRun(dhtCollectJob, &status, I2C_BUS_FAST_HZ, 50);
+  }
+
+  if (status != DHT20_OK)
+    return status;
+
+  readConverted(temperature, humidity);
+  return DHT20_OK;
+}
+
 static DisplayState computeDisplayState(uint8_t tempLevel, uint8_t humiLevel)
 {
   // CRITICAL nếu quá nóng hoặc quá ẩm
@@ -107,41 +349,100 @@ static DisplayState computeDisplayState(uint8_t tempLevel, uint8_t humiLevel)
   return DISPLAY_STATE_NORMAL;
 }
 
-static void updateLcd(float temperature, float humidity, DisplayState state)
+// Subscriber LCD: chạy ngay trong task monitor (publisher) khi có mẫu mới
+static void lcdOnSample(const EventMsg *msg, void *ctx)
 {
-  lcd.clear();
+  TRACE_SCOPE("lcd_update");
+  const SensorSnapshot &snap = msg->as<SensorSnapshot>();
+  sample_t temperature;
+  sample_t humidity;
+  snapshotValues(snap, temperature, humidity);
+  updateLcd(temperature, humidity, computeDisplayState(snap.temp_level, snap.humi_level),
+            snap.acquired_us);
+}
 
+static void updateLcd(sample_t temperature, sample_t humidity, DisplayState state,
+                      uint32_t acquiredUs)
+{
+  LcdFrame frame = {temperature, humidity, state, acquiredUs};
+  i2cBusRun(lcdUpdateJob, &frame, I2C_BUS_STD_HZ, 200);
+}
+
+// ====== Job I2C: chạy trong task I2C bus ======
+static bool dhtProbeJob(TwoWire &wire, void *arg)
+{
+  return dht20.isConnected();
+}
+
+static bool dhtTriggerJob(TwoWire &wire, void *arg)
+{
+  int *status = (int *)arg;
+  *status = dht20.startMeasurement();
+  i2cBusNoteWireError(*status);
+  // LASTREAD là chưa đủ khoảng cách tối thiểu, không phải lỗi bus
+  return *status == 0 || *status == DHT20_ERROR_LASTREAD;
+}
+
+static bool dhtCollectJob(TwoWire &wire, void *arg)
+{
+  int *status = (int *)arg;
+  *status = dht20.collectMeasurement();
+  // BUSY là cảm biến chưa đo xong, không phải lỗi bus
+  return *status == DHT20_OK || *status == DHT20_ERROR_BUSY;
+}
+
+static bool lcdInitJob(TwoWire &wire, void *arg)
+{
+  lcd.begin();
+  // Mỗi ký tự / mỗi dòng thay đổi đi trong 1 giao dịch I2C thay vì 6 / 96
+  lcd.setBatchMode(true);
+  lcd.backlight();
+  lcd.clear();
   lcd.setCursor(0, 0);
+  lcd.print("DHT20 starting...");
+  lcd.setCursor(0, 1);
+  lcd.print("Please wait");
+  // Màn hình đã bị ghi trực tiếp → lần flush đầu vẽ lại toàn bộ
+  lcdFb.invalidate();
+  return true;
+}
+
+static bool lcdUpdateJob(TwoWire &wire, void *arg)
+{
+  TRACE_SCOPE("lcd_flush");
+  const LcdFrame *frame = (const LcdFrame *)arg;
+  DisplayState state = frame->state;
+
   switch (state)
   {
   case DISPLAY_STATE_NORMAL:
-    lcd.print("State: NORMAL ");
+    lcdFb.setLine(0, "State: NORMAL ");
     break;
   case DISPLAY_STATE_WARNING:
-    lcd.print("State: WARN   ");
+    lcdFb.setLine(0, "State: WARN   ");
     break;
   case DISPLAY_STATE_CRITICAL:
-    lcd.print("State: CRITIC!");
+    lcdFb.setLine(0, "State: CRITIC!");
     break;
   }
 
-  lcd.setCursor(0, 1);
-  lcd.print("T:");
-  lcd.print(temperature, 1);
-  lcd.print("C ");
-  lcd.print("H:");
-  lcd.print(humidity, 0);
-  lcd.print("%");
+  char tempText[8];
+  char humiText[8];
+  formatSample(tempText, sizeof(tempText), frame->temperature, 1);
+  formatSample(humiText, sizeof(humiText), frame->humidity, 0);
+
+  char line[LCD_FB_COLS + 1];
+  snprintf(line, sizeof(line), "T:%sC H:%s%%", tempText, humiText);
+  lcdFb.setLine(1, line);
+
+  // Giá trị không đổi → flush không gửi byte nào lên bus
+  lcdFb.flush();
+  latencyRecord(LATENCY_SINK_LCD, frame->acquiredUs);
+  return true;
 }
 
-static void sendSensorToWeb(float temperature, float humidity)
+void levelStatsToJson(JsonObject out)
 {
-  StaticJsonDocument<128> doc;
-  doc["page"] = "sensor";
-  doc["temp"] = temperature;
-  doc["humi"] = humidity;
-
-  String json;
-  serializeJson(doc, json);
-  Webserver_sendata(json);
+  tempTracker.toJson(out.createNestedObject("temp"));
+  humiTracker.toJson(out.createNestedObject("humi"));
 }
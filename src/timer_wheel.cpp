@@ -0,0 +1,344 @@
+#include "timer_wheel.h"
+#include "esp_timer.h"
+
+#define TW_L0_SIZE    256
+#define TW_LN_SIZE    64
+#define TW_L1_SHIFT   8
+#define TW_L2_SHIFT   14
+#define TW_L1_SPAN    (1UL << TW_L2_SHIFT)   // tick tối đa xếp được ở tầng 0 + 1
+#define TW_L2_SPAN    (1UL << 20)            // tick tối đa xếp được ở cả 3 tầng
+#define TW_TICK_US    ((int64_t)TIMER_WHEEL_TICK_MS * 1000)
+
+static WheelTimer *wheelL0[TW_L0_SIZE];
+static WheelTimer *wheelL1[TW_LN_SIZE];
+static WheelTimer *wheelL2[TW_LN_SIZE];
+static uint32_t    l0Bitmap[TW_L0_SIZE / 32];   // ô tầng 0 có thể khác rỗng
+static uint16_t    levelCount[3];
+
+static uint32_t    wheelTick    = 0;       // tick kế tiếp chưa xử lý
+static bool        cascadeDone  = false;   // đã dồn tầng trên cho wheelTick chưa
+static bool        armed        = false;
+static uint32_t    armedTick    = 0;
+
+static esp_timer_handle_t wheelTimer = nullptr;
+static portMUX_TYPE       wheelMux   = portMUX_INITIALIZER_UNLOCKED;
+
+static inline uint32_t nowTick()
+{
+  return (uint32_t)(esp_timer_get_time() / TW_TICK_US);
+}
+
+// ====== Danh sách trong ô ======
+static void unlinkTimer(WheelTimer *t)
+{
+  *t->pprev = t->next;
+  if (t->next != nullptr)
+    t->next->pprev = t->pprev;
+  t->next  = nullptr;
+  t->pprev = nullptr;
+  levelCount[t->level]--;
+}
+
+static void insertTimer(WheelTimer *t)
+{
+  int32_t delta = (int32_t)(t->expires - wheelTick);
+  if (delta < 0)
+  {
+    t->expires = wheelTick;
+    delta = 0;
+  }
+
+  WheelTimer **head;
+  if ((uint32_t)delta < TW_L0_SIZE)
+  {
+    uint32_t idx = t->expires & (TW_L0_SIZE - 1);
+    head = &wheelL0[idx];
+    l0Bitmap[idx >> 5] |= 1UL << (idx & 31);
+    t->level = 0;
+  }
+  else if ((uint32_t)delta < TW_L1_SPAN)
+  {
+    head = &wheelL1[(t->expires >> TW_L1_SHIFT) & (TW_LN_SIZE - 1)];
+    t->level = 1;
+  }
+  else
+  {
+    // Xa hơn tầm của wheel: tạm đặt ở ô xa nhất, tới lượt sẽ được xếp lại
+    uint32_t slotTick = ((uint32_t)delta < TW_L2_SPAN) ? t->expires : wheelTick + TW_L2_SPAN - 1;
+    head = &wheelL2[(slotTick >> TW_L2_SHIFT) & (TW_LN_SIZE - 1)];
+    t->level = 2;
+  }
+
+  t->next = *head;
+  if (t->next != nullptr)
+    t->next->pprev = &t->next;
+  *head    = t;
+  t->pprev = head;
+  levelCount[t->level]++;
+}
+
+// Dồn một ô tầng trên xuống các tầng dưới
+static void cascadeSlot(WheelTimer **head)
+{
+  WheelTimer *t = *head;
+  while (t != nullptr)
+  {
+    WheelTimer *next = t->next;
+    unlinkTimer(t);
+    insertTimer(t);
+    t = next;
+  }
+}
+
+static void cascadeAt(uint32_t tick)
+{
+  if ((tick & (TW_L0_SIZE - 1)) != 0)
+    return;
+  if ((tick & (TW_L1_SPAN - 1)) == 0)
+    cascadeSlot(&wheelL2[(tick >> TW_L2_SHIFT) & (TW_LN_SIZE - 1)]);
+  cascadeSlot(&wheelL1[(tick >> TW_L1_SHIFT) & (TW_LN_SIZE - 1)]);
+}
+
+// Tick gần nhất (>= from) có việc: ô tầng 0 khác rỗng hoặc mốc dồn tầng trên
+static bool nextEventTick(uint32_t from, uint32_t &out)
+{
+  bool found = false;
+  uint32_t best = 0;
+
+  if (levelCount[0] > 0)
+  {
+    uint32_t start = from & (TW_L0_SIZE - 1);
+    for (uint32_t i = 0; i < TW_L0_SIZE; ++i)
+    {
+      uint32_t idx = (start + i) & (TW_L0_SIZE - 1);
+      uint32_t word = l0Bitmap[idx >> 5] >> (idx & 31);
+      if (word == 0)
+      {
+        i += 31 - (idx & 31);   // bỏ qua phần còn lại của word
+        continue;
+      }
+      if ((word & 1) == 0)
+        continue;
+      if (wheelL0[idx] == nullptr)
+      {
+        l0Bitmap[idx >> 5] &= ~(1UL << (idx & 31));   // bit cũ, ô đã bị huỷ hết
+        continue;
+      }
+      best  = from + i;
+      found = true;
+      break;
+    }
+  }
+
+  if (levelCount[1] > 0)
+  {
+    uint32_t boundary = (from + TW_L0_SIZE - 1) & ~(TW_L0_SIZE - 1);
+    if (!found || (int32_t)(boundary - best) < 0)
+    {
+      best  = boundary;
+      found = true;
+    }
+  }
+
+  if (levelCount[2] > 0)
+  {
+    uint32_t boundary = (from + TW_L1_SPAN - 1) & ~(TW_L1_SPAN - 1);
+    if (!found || (int32_t)(boundary - best) < 0)
+    {
+      best  = boundary;
+      found = true;
+    }
+  }
+
+  out = best;
+  return found;
+}
+
+// Hẹn esp_timer tới tick có việc kế tiếp (gọi trong critical section)
+static void armNext()
+{
+  uint32_t next;
+  if (!nextEventTick(wheelTick, next))
+  {
+    if (armed)
+      esp_timer_stop(wheelTimer);
+    armed = false;
+    return;
+  }
+
+  if (armed && armedTick == next)
+    return;
+
+  int64_t now     = esp_timer_get_time();
+  int64_t delayUs = (int64_t)(int32_t)(next - (uint32_t)(now / TW_TICK_US)) * TW_TICK_US
+                    - now % TW_TICK_US;
+  if (delayUs < 1)
+    delayUs = 1;
+
+  esp_timer_stop(wheelTimer);
+  esp_timer_start_once(wheelTimer, (uint64_t)delayUs);
+  armed     = true;
+  armedTick = next;
+}
+
+static void dispatch(WheelTimer *t)
+{
+  switch (t->kind)
+  {
+  case WHEEL_TIMER_CALLBACK:
+    t->target.callback.fn(t->target.callback.ctx);
+    break;
+  case WHEEL_TIMER_QUEUE:
+    xQueueSend(t->target.queue.queue, &t->target.queue.item, 0);
+    break;
+  case WHEEL_TIMER_NOTIFY:
+    xTaskNotify(t->target.notify.task, t->target.notify.bits, eSetBits);
+    break;
+  }
+}
+
+// ====== Callback của esp_timer ======
+static void onWheelTimer(void *arg)
+{
+  for (;;)
+  {
+    WheelTimer *batch[TIMER_WHEEL_BATCH];
+    size_t count = 0;
+    bool more = false;
+
+    portENTER_CRITICAL(&wheelMux);
+    armed = false;
+    uint32_t target = nowTick();
+    while ((int32_t)(target - wheelTick) >= 0)
+    {
+      if (!cascadeDone)
+      {
+        cascadeAt(wheelTick);
+        cascadeDone = true;
+      }
+
+      uint32_t idx = wheelTick & (TW_L0_SIZE - 1);
+      WheelTimer **slot = &wheelL0[idx];
+      while (*slot != nullptr && count < TIMER_WHEEL_BATCH)
+      {
+        WheelTimer *t = *slot;
+        unlinkTimer(t);
+        batch[count++] = t;
+        if (t->period != 0)
+        {
+          t->expires = wheelTick + t->period;
+          insertTimer(t);
+        }
+      }
+      if (*slot != nullptr)
+      {
+        more = true;   // batch đầy: dispatch rồi xử lý tiếp cùng tick
+        break;
+      }
+      l0Bitmap[idx >> 5] &= ~(1UL << (idx & 31));
+
+      // Nhảy thẳng tới tick có việc kế tiếp thay vì đi từng tick rỗng
+      uint32_t next;
+      if (nextEventTick(wheelTick + 1, next) && (int32_t)(next - target) <= 0)
+        wheelTick = next;
+      else
+        wheelTick = target + 1;
+      cascadeDone = false;
+    }
+    if (!more)
+      armNext();
+    portEXIT_CRITICAL(&wheelMux);
+
+    for (size_t i = 0; i < count; ++i)
+      dispatch(batch[i]);
+
+    if (!more)
+      return;
+  }
+}
+
+// ====== API ======
+void timerWheelBegin()
+{
+  if (wheelTimer != nullptr)
+    return;
+
+  esp_timer_create_args_t args = {};
+  args.callback        = onWheelTimer;
+  args.arg             = nullptr;
+  args.dispatch_method = ESP_TIMER_TASK;
+  args.name            = "timer_wheel";
+  esp_timer_create(&args, &wheelTimer);
+
+  wheelTick = nowTick();
+}
+
+static void initTimer(WheelTimer &t, uint8_t kind)
+{
+  t.next    = nullptr;
+  t.pprev   = nullptr;
+  t.expires = 0;
+  t.period  = 0;
+  t.level   = 0;
+  t.kind    = kind;
+}
+
+void wheelTimerInitCallback(WheelTimer &t, WheelTimerFn fn, void *ctx)
+{
+  initTimer(t, WHEEL_TIMER_CALLBACK);
+  t.target.callback.fn  = fn;
+  t.target.callback.ctx = ctx;
+}
+
+void wheelTimerInitQueue(WheelTimer &t, QueueHandle_t queue, uint32_t item)
+{
+  initTimer(t, WHEEL_TIMER_QUEUE);
+  t.target.queue.queue = queue;
+  t.target.queue.item  = item;
+}
+
+void wheelTimerInitNotify(WheelTimer &t, TaskHandle_t task, uint32_t bits)
+{
+  initTimer(t, WHEEL_TIMER_NOTIFY);
+  t.target.notify.task = task;
+  t.target.notify.bits = bits;
+}
+
+void wheelTimerStart(WheelTimer &t, uint32_t delayMs, uint32_t periodMs)
+{
+  uint32_t periodTicks = (periodMs + TIMER_WHEEL_TICK_MS - 1) / TIMER_WHEEL_TICK_MS;
+
+  portENTER_CRITICAL(&wheelMux);
+  if (t.pprev != nullptr)
+    unlinkTimer(&t);
+
+  // Wheel rỗng thì không có gì giữa wheelTick và hiện tại: đuổi kịp luôn
+  int64_t nowUs = esp_timer_get_time();
+  if (levelCount[0] == 0 && levelCount[1] == 0 && levelCount[2] == 0)
+  {
+    wheelTick   = (uint32_t)(nowUs / TW_TICK_US);
+    cascadeDone = false;
+  }
+
+  // Làm tròn lên theo thời gian thực: không bao giờ chạy sớm, trễ tối đa 1 tick
+  t.expires = (uint32_t)((nowUs + (int64_t)delayMs * 1000 + TW_TICK_US - 1) / TW_TICK_US);
+  t.period  = periodTicks;
+  insertTimer(&t);
+
+  if (!armed || (int32_t)(t.expires - armedTick) < 0)
+    armNext();
+  portEXIT_CRITICAL(&wheelMux);
+}
+
+void wheelTimerCancel(WheelTimer &t)
+{
+  portENTER_CRITICAL(&wheelMux);
+  if (t.pprev != nullptr)
+    unlinkTimer(&t);
+  portEXIT_CRITICAL(&wheelMux);
+}
+
+bool wheelTimerActive(const WheelTimer &t)
+{
+  return t.pprev != nullptr;
+}
@@ -1,5 +1,8 @@
 #include "tinyml.h"
-#include "task_webserver.h"
+#include "event_bus.h"
+#include "metrics.h"
+#include "trace.h"
+#include "logger.h"
 
 // Buffer & đối tượng TFLM
 namespace {
@@ -13,9 +16,9 @@ namespace {
   TfLiteTensor *output = nullptr;
 }
 
-static bool computeGroundTruthAnomaly(float temp, float humi);
-static void sendResultToWeb(float score, bool predictedAnomaly,
-                            bool groundTruthAnomaly, float onlineAccuracy);
+static bool computeGroundTruthAnomaly(const SensorSnapshot &snap);
+static void publishResult(uint32_t sampleSeq, float score, bool predictedAnomaly,
+                          bool groundTruthAnomaly, float onlineAccuracy);
 
 void setupTinyML()
 {
@@ -45,7 +48,7 @@ void setupTinyML()
   input  = interpreter->input(0);
   output = interpreter->output(0);
 
-  Serial.println("TensorFlow Lite Micro initialized on ESP32.");
+  LOGI(ML, "TensorFlow Lite Micro initialized on ESP32.");
 }
 
 void tiny_ml_task(void *pvParameters)
@@ -55,30 +58,42 @@ void tiny_ml_task(void *pvParameters)
   uint32_t totalSamples   = 0;
   uint32_t correctSamples = 0;
 
+  // Chỉ giữ mẫu mới nhất: nếu suy luận chậm hơn tốc độ lấy mẫu thì bỏ mẫu cũ
+  EventSubscription *sampleSub = eventSubscribeLatest(TOPIC_MASK(TOPIC_SENSOR_SAMPLE));
+
   for (;;)
   {
-    // Chuẩn bị input: dùng glob_temperature & glob_humidity
+    // Ngủ tới khi có mẫu cảm biến mới
+    EventMsg *msg = eventReceive(sampleSub, portMAX_DELAY);
+    if (msg == nullptr)
+      continue;
+    SensorSnapshot snap = msg->as<SensorSnapshot>();
+    eventRelease(msg);
+
+    // Chuẩn bị input: nhiệt độ & độ ẩm của cùng một mẫu
     if (input != nullptr &&
         input->type == kTfLiteFloat32 &&
         input->bytes >= 2 * sizeof(float))
     {
-      input->data.f[0] = glob_temperature;
-      input->data.f[1] = glob_humidity;
+      input->data.f[0] = snap.temperature;
+      input->data.f[1] = snap.humidity;
     }
 
     // Chạy suy luận
-    if (interpreter == nullptr || interpreter->Invoke() != kTfLiteOk)
+    TRACE_BEGIN("tflm_invoke");
+    bool invoked = interpreter != nullptr && interpreter->Invoke() == kTfLiteOk;
+    TRACE_END("tflm_invoke");
+    if (!invoked)
     {
       if (error_reporter)
         error_reporter->Report("Invoke failed");
-      vTaskDelay(pdMS_TO_TICKS(2000));
       continue;
     }
+    metricInc(METRIC_INFERENCES);
 
     float result = output->data.f[0];            
     bool predictedAnomaly   = (result > 0.6f);    // >0.6 => bất thường
-    bool groundTruthAnomaly = computeGroundTruthAnomaly(glob_temperature,
-                                                        glob_humidity);
+    bool groundTruthAnomaly = computeGroundTruthAnomaly(snap);
 
     totalSamples++;
     if (predictedAnomaly == groundTruthAnomaly)
@@ -88,48 +103,27 @@ void tiny_ml_task(void *pvParameters)
                                ? (100.0f * (float)correctSamples / (float)totalSamples)
                                : 0.0f;                      
 
-    Serial.print("[TinyML] score=");
-    Serial.print(result, 3);
-    Serial.print(" pred=");
-    Serial.print(predictedAnomaly ? "ANOM" : "OK");
-    Serial.print(" gt=");
-    Serial.print(groundTruthAnomaly ? "ANOM" : "OK");
-    Serial.print(" acc=");
-    Serial.print(onlineAccuracy, 1);
-    Serial.println("%");
-
-    // Gửi sang Web UI và cập nhật biến global cho CoreIoT
-    sendResultToWeb(result, predictedAnomaly, groundTruthAnomaly, onlineAccuracy);
+    LOGI(ML, "score=%.3f pred=%s gt=%s acc=%.1f%%", result,
+         predictedAnomaly ? "ANOM" : "OK", groundTruthAnomaly ? "ANOM" : "OK", onlineAccuracy);
 
-    vTaskDelay(pdMS_TO_TICKS(5000));
+    // Phát kết quả: Web UI, CoreIoT và bộ lấy mẫu thích ứng tự nhận
+    TRACE_SCOPE("ml_publish");
+    publishResult(snap.seq, result, predictedAnomaly, groundTruthAnomaly, onlineAccuracy);
   }
 }
 
-static bool computeGroundTruthAnomaly(float temp, float humi)
+// Nhãn theo mức đã qua hysteresis + dwell của monitor: nhiễu sát ngưỡng
+// không làm nhãn lật qua lại giữa các mẫu
+static bool computeGroundTruthAnomaly(const SensorSnapshot &snap)
 {
-  bool tempBad = (temp < tempColdThreshold) || (temp > tempHotThreshold);
-  bool humiBad = (humi < humiDryThreshold) || (humi > humiHumidThreshold);
+  bool tempBad = snap.temp_level != TEMP_LEVEL_NORMAL;
+  bool humiBad = snap.humi_level != HUMI_LEVEL_OK;
   return tempBad || humiBad;
 }
 
-static void sendResultToWeb(float score, bool predictedAnomaly,
-                            bool groundTruthAnomaly, float onlineAccuracy)
+static void publishResult(uint32_t sampleSeq, float score, bool predictedAnomaly,
+                          bool groundTruthAnomaly, float onlineAccuracy)
 {
-  // Cập nhật biến toàn cục TinyML (cho CoreIoT / dashboard khác)
-  tinyml_score        = score;
-  tinyml_accuracy     = onlineAccuracy;
-  tinyml_pred_anomaly = predictedAnomaly;
-  tinyml_gt_anomaly   = groundTruthAnomaly;
-
-  // Gửi sang WebServer
-  StaticJsonDocument<192> doc;
-  doc["page"]  = "tinyml";
-  doc["score"] = score;
-  doc["pred"]  = predictedAnomaly ? "ANOM" : "OK";
-  doc["gt"]    = groundTruthAnomaly ? "ANOM" : "OK";
-  doc["acc"]   = onlineAccuracy;
-
-  String json;
-  serializeJson(doc, json);
-  Webserver_sendata(json);
+  MlResultEvent ev = {score, onlineAccuracy, predictedAnomaly, groundTruthAnomaly, sampleSeq};
+  eventPublish(TOPIC_ML_RESULT, ev);
 }
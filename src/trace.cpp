@@ -0,0 +1,204 @@
+#include "trace.h"
+
+#ifdef TRACE_ENABLED
+
+#include <atomic>
+#include <algorithm>
+#include <esp_timer.h>
+
+static_assert((TRACE_BUFFER_EVENTS & (TRACE_BUFFER_EVENTS - 1)) == 0,
+              "TRACE_BUFFER_EVENTS phải là lũy thừa của 2");
+
+// Mỗi core một ring: writer chỉ ghi ring của core mình nên không tranh chấp
+// cache line với core kia. Task / ISR trên cùng core chiếm ô bằng fetch_add,
+// rồi đánh dấu ô bằng seq (seqlock như runtime_config): 0 = đang ghi,
+// idx + 1 = đã ghi xong sự kiện thứ idx.
+struct TraceSlot {
+  std::atomic<uint32_t> seq;
+  uint32_t              tsUs;
+  const char           *name;
+  TaskHandle_t          task;
+  uint8_t               phase;
+};
+
+struct TraceRing {
+  std::atomic<uint32_t> head;   // số sự kiện đã ghi từ lúc boot
+  TraceSlot             slots[TRACE_BUFFER_EVENTS];
+};
+
+static TraceRing rings[portNUM_PROCESSORS];
+
+void traceRecord(const char *name, TracePhase phase)
+{
+  TraceRing &ring = rings[xPortGetCoreID()];
+  uint32_t idx = ring.head.fetch_add(1, std::memory_order_relaxed);
+  TraceSlot &slot = ring.slots[idx & (TRACE_BUFFER_EVENTS - 1)];
+
+  slot.seq.store(0, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  slot.tsUs  = (uint32_t)esp_timer_get_time();
+  slot.name  = name;
+  slot.task  = xPortInIsrContext() ? nullptr : xTaskGetCurrentTaskHandle();
+  slot.phase = phase;
+  slot.seq.store(idx + 1, std::memory_order_release);
+}
+
+// ====== Xuất Chrome trace ======
+enum {
+  EXPORT_HEADER = 0,
+  EXPORT_TASKS,
+  EXPORT_EVENTS,
+  EXPORT_FOOTER,
+  EXPORT_DONE
+};
+
+TraceExport::TraceExport()
+    : _events(nullptr), _eventCount(0), _tasks(nullptr), _taskCount(0), _dropped(0),
+      _nowUs(0), _nowLow(0), _stage(EXPORT_HEADER), _index(0), _lineLen(0), _lineOff(0)
+{
+  _events = (TraceEvent *)malloc(sizeof(TraceEvent) * TRACE_BUFFER_EVENTS * portNUM_PROCESSORS);
+  if (_events == nullptr)
+    return;
+
+  _nowUs  = (uint64_t)esp_timer_get_time();
+  _nowLow = (uint32_t)_nowUs;
+
+  for (uint8_t core = 0; core < portNUM_PROCESSORS; ++core)
+  {
+    TraceRing &ring = rings[core];
+    uint32_t head  = ring.head.load(std::memory_order_acquire);
+    uint32_t start = head > TRACE_BUFFER_EVENTS ? head - TRACE_BUFFER_EVENTS : 0;
+    _dropped += start;
+
+    for (uint32_t idx = start; idx < head; ++idx)
+    {
+      TraceSlot &slot = ring.slots[idx & (TRACE_BUFFER_EVENTS - 1)];
+      if (slot.seq.load(std::memory_order_acquire) != idx + 1)
+        continue;   // đang ghi dở hoặc đã bị sự kiện mới hơn ghi đè
+
+      TraceEvent &ev = _events[_eventCount];
+      ev.tsUs  = slot.tsUs;
+      ev.name  = slot.name;
+      ev.task  = slot.task;
+      ev.phase = slot.phase;
+      ev.core  = core;
+
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (slot.seq.load(std::memory_order_relaxed) == idx + 1)
+        _eventCount++;
+    }
+  }
+
+  // Gộp 2 core theo thời gian: tuổi sự kiện so với lúc chụp không bị ảnh
+  // hưởng khi 32 bit thấp của timer quay vòng (~71 phút)
+  uint32_t nowLow = _nowLow;
+  std::sort(_events, _events + _eventCount, [nowLow](const TraceEvent &a, const TraceEvent &b) {
+    return (uint32_t)(nowLow - a.tsUs) > (uint32_t)(nowLow - b.tsUs);
+  });
+
+  // Tên task chép ra lúc chụp: task bị xoá sau đó không để lại con trỏ treo
+#if configUSE_TRACE_FACILITY
+  UBaseType_t capacity = uxTaskGetNumberOfTasks() + 4;
+  TaskStatus_t *status = (TaskStatus_t *)malloc(capacity * sizeof(TaskStatus_t));
+  if (status != nullptr)
+  {
+    UBaseType_t count = uxTaskGetSystemState(status, capacity, nullptr);
+    _tasks = (TaskName *)malloc(count * sizeof(TaskName));
+    if (_tasks != nullptr)
+    {
+      for (UBaseType_t i = 0; i < count && i < 255; ++i)
+      {
+        _tasks[i].handle = status[i].xHandle;
+        snprintf(_tasks[i].name, sizeof(_tasks[i].name), "%s", status[i].pcTaskName);
+        _taskCount++;
+      }
+    }
+    free(status);
+  }
+#endif
+}
+
+TraceExport::~TraceExport()
+{
+  free(_events);
+  free(_tasks);
+}
+
+// Dựng dòng JSON kế tiếp vào _line; false khi đã hết
+bool TraceExport::nextLine()
+{
+  int n = 0;
+  switch (_stage)
+  {
+  case EXPORT_HEADER:
+    // Sự kiện ISR dùng tid 0
+    n = snprintf(_line, sizeof(_line),
+                 "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n"
+                 "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"ESP32-S3\"}},\n"
+                 "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"ISR\"}}");
+    _stage = EXPORT_TASKS;
+    break;
+
+  case EXPORT_TASKS:
+    if (_index >= _taskCount)
+    {
+      _stage = EXPORT_EVENTS;
+      _index = 0;
+      return nextLine();
+    }
+    n = snprintf(_line, sizeof(_line),
+                 ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%lu,\"args\":{\"name\":\"%s\"}}",
+                 (unsigned long)(uintptr_t)_tasks[_index].handle, _tasks[_index].name);
+    _index++;
+    break;
+
+  case EXPORT_EVENTS:
+  {
+    if (_index >= _eventCount)
+    {
+      _stage = EXPORT_FOOTER;
+      return nextLine();
+    }
+    const TraceEvent &ev = _events[_index++];
+    uint64_t ts = _nowUs - (uint32_t)(_nowLow - ev.tsUs);
+    n = snprintf(_line, sizeof(_line),
+                 ",\n{\"name\":\"%s\",\"ph\":\"%c\",%s\"ts\":%llu,\"pid\":1,\"tid\":%lu,\"args\":{\"core\":%u}}",
+                 ev.name, (char)ev.phase, ev.phase == TRACE_PHASE_INSTANT ? "\"s\":\"t\"," : "",
+                 (unsigned long long)ts, (unsigned long)(uintptr_t)ev.task, (unsigned)ev.core);
+    break;
+  }
+
+  case EXPORT_FOOTER:
+    n = snprintf(_line, sizeof(_line), "\n],\"otherData\":{\"dropped\":%lu}}\n",
+                 (unsigned long)_dropped);
+    _stage = EXPORT_DONE;
+    break;
+
+  default:
+    return false;
+  }
+
+  if (n < 0)
+    n = 0;
+  _lineLen = (uint16_t)std::min<size_t>((size_t)n, sizeof(_line) - 1);
+  _lineOff = 0;
+  return true;
+}
+
+// Dòng không vừa phần còn lại của buf được cắt và gửi tiếp ở lần gọi sau
+size_t TraceExport::read(char *buf, size_t len)
+{
+  size_t written = 0;
+  while (written < len)
+  {
+    if (_lineOff >= _lineLen && !nextLine())
+      break;
+    size_t n = std::min<size_t>(len - written, _lineLen - _lineOff);
+    memcpy(buf + written, _line + _lineOff, n);
+    written  += n;
+    _lineOff += n;
+  }
+  return written;
+}
+
+#endif